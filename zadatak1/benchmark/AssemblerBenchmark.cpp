@@ -0,0 +1,153 @@
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <cstdlib>
+#include <atomic>
+#include <new>
+#include <sys/resource.h>
+
+#include "../inc/Parser.h"
+#include "../inc/FileReader.h"
+
+using namespace std;
+
+// Assembles one file and prints a single JSON object with the time of every phase,
+// the throughput, the heap allocations made by the compile and the peak resident set
+// size of the process.
+// Usage: assembler_benchmark <input.s> <output> [--name NAME] [--one-pass] [--format=binary] [-j THREADS]
+
+// every heap allocation of the process goes through here and is counted
+atomic<unsigned long> allocationCount(0);
+
+void *operator new(size_t size)
+{
+    allocationCount++;
+    void *memory = malloc(size > 0 ? size : 1);
+    if (!memory)
+    {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+int countLines(const string &path)
+{
+    FileReader reader(path);
+    int lines = 0;
+    string_view line;
+    reader.getNextLine(line);
+    while (!reader.isEndOfFile())
+    {
+        lines++;
+        reader.getNextLine(line);
+    }
+    return lines;
+}
+
+string jsonString(const string &text)
+{
+    string quoted = "\"";
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 3)
+    {
+        cout << "Usage: assembler_benchmark <input.s> <output> [--name NAME] [--one-pass] [--format=binary] [-j THREADS]" << endl;
+        return 1;
+    }
+
+    string inputFile = argv[1], outputFile = argv[2], name = inputFile;
+    int threadCount = 0;
+    Parser *parser = new Parser();
+    parser->setFilesPath(inputFile, outputFile);
+    for (int i = 3; i < argc; i++)
+    {
+        string argument = argv[i];
+        if (argument == "--name" && i + 1 < argc)
+            name = argv[++i];
+        else if (argument == "--one-pass")
+            parser->setOnePass(true);
+        else if (argument == "--format=binary")
+            parser->setOutputFormat(Parser::BINARY);
+        else if (argument == "-j" && i + 1 < argc)
+            threadCount = atoi(argv[++i]);
+    }
+    WorkerPool *pool = new WorkerPool(threadCount);
+    threadCount = pool->getThreadCount();
+    parser->setWorkerPool(pool);
+
+    int lines = countLines(inputFile);
+
+    stringstream messages;
+    unsigned long allocationsBefore = allocationCount;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bool success = parser->compile(messages);
+    double total = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    unsigned long allocations = allocationCount - allocationsBefore;
+    Parser::Statistics statistics = parser->getStatistics();
+    delete parser;
+    delete pool;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    cout.setf(ios::fixed);
+    cout.precision(3);
+    cout << "{\"name\": " << jsonString(name)
+         << ", \"success\": " << (success ? "true" : "false")
+         << ", \"threads\": " << threadCount
+         << ", \"lines\": " << lines
+         << ", \"cleanup_ms\": " << statistics.cleanupTime
+         << ", \"first_pass_ms\": " << statistics.firstPassTime
+         << ", \"second_pass_ms\": " << statistics.secondPassTime
+         << ", \"output_ms\": " << statistics.outputTime
+         << ", \"total_ms\": " << total;
+    cout.precision(0);
+    cout << ", \"lines_per_sec\": " << (total > 0 ? lines * 1000.0 / total : 0)
+         << ", \"allocations\": " << allocations;
+    cout.precision(3);
+    cout << ", \"allocations_per_line\": " << (lines > 0 ? (double)allocations / lines : 0);
+    cout.precision(0);
+    cout << ", \"peak_rss_kb\": " << usage.ru_maxrss << "}" << endl;
+
+    if (!success)
+    {
+        cerr << messages.str();
+        return 1;
+    }
+    return 0;
+}
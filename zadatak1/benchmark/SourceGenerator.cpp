@@ -0,0 +1,273 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdlib>
+
+using namespace std;
+
+// Writes a valid assembly source of the given shape to stdout.
+// Usage: source_generator [--lines N] [--symbols N] [--sections N] [--word-density D]
+//                         [--mix imm:W,mem:W,pcrel:W,reg:W,regind:W,displ:W] [--seed N]
+
+struct GeneratorOptions
+{
+    int lines, symbols, sections, externs, seed;
+    double wordDensity;
+    // weights of the addressing modes used by jumps and loads/stores
+    int immediate, memory, pcRelative, registerDirect, registerIndirect, displacement;
+    GeneratorOptions() : lines(10000), symbols(1000), sections(4), externs(16), seed(1), wordDensity(0.1),
+                         immediate(3), memory(2), pcRelative(2), registerDirect(2), registerIndirect(1), displacement(1) {}
+};
+
+mt19937 generator;
+
+int randomNumber(int count)
+{
+    return count > 0 ? generator() % count : 0;
+}
+
+string randomRegister()
+{
+    int reg = randomNumber(9);
+    return reg == 8 ? "psw" : "r" + to_string(reg);
+}
+
+string randomLiteral()
+{
+    switch (randomNumber(3))
+    {
+    case 0:
+        return to_string(randomNumber(1000));
+    case 1:
+        return "-" + to_string(1 + randomNumber(100));
+    default:
+    {
+        const char *digits = "0123456789ABCDEF";
+        string literal = "0x";
+        for (int i = 0; i < 1 + randomNumber(4); i++)
+        {
+            literal += digits[randomNumber(16)];
+        }
+        return literal;
+    }
+    }
+}
+
+string randomSymbol(const GeneratorOptions &options)
+{
+    if (options.externs > 0 && randomNumber(10) == 0)
+    {
+        return "ext" + to_string(randomNumber(options.externs));
+    }
+    return "label" + to_string(randomNumber(options.symbols));
+}
+
+string randomValue(const GeneratorOptions &options)
+{
+    return randomNumber(2) == 0 ? randomSymbol(options) : randomLiteral();
+}
+
+int randomMode(const GeneratorOptions &options)
+{
+    int weights[] = {options.immediate, options.memory, options.pcRelative, options.registerDirect, options.registerIndirect, options.displacement};
+    int total = 0;
+    for (int weight : weights)
+        total += weight;
+
+    int pick = randomNumber(total);
+    for (int mode = 0; mode < 6; mode++)
+    {
+        if (pick < weights[mode])
+            return mode;
+        pick -= weights[mode];
+    }
+    return 0;
+}
+
+string jumpInstruction(const GeneratorOptions &options)
+{
+    const char *jumps[] = {"call", "jmp", "jeq", "jne", "jgt"};
+    string line = string(jumps[randomNumber(5)]) + " ";
+    switch (randomMode(options))
+    {
+    case 0:
+        return line + randomValue(options);
+    case 1:
+        return line + "*" + randomValue(options);
+    case 2:
+        return line + "%label" + to_string(randomNumber(options.symbols));
+    case 3:
+        return line + "*" + randomRegister();
+    case 4:
+        return line + "*[" + randomRegister() + "]";
+    default:
+        return line + "*[" + randomRegister() + " + " + randomValue(options) + "]";
+    }
+}
+
+string loadStoreInstruction(const GeneratorOptions &options)
+{
+    int mode = randomMode(options);
+    string line = string(mode == 0 || randomNumber(2) == 0 ? "ldr " : "str ") + randomRegister() + ", ";
+    switch (mode)
+    {
+    case 0:
+        return line + "$" + randomValue(options);
+    case 1:
+        return line + randomValue(options);
+    case 2:
+        return line + "%label" + to_string(randomNumber(options.symbols));
+    case 3:
+        return line + randomRegister();
+    case 4:
+        return line + "[" + randomRegister() + "]";
+    default:
+        return line + "[" + randomRegister() + " + " + randomValue(options) + "]";
+    }
+}
+
+string instruction(const GeneratorOptions &options)
+{
+    const char *noOperand[] = {"halt", "iret", "ret"};
+    const char *oneRegister[] = {"push", "pop", "int", "not"};
+    const char *twoRegisters[] = {"xchg", "add", "sub", "mul", "div", "cmp", "and", "or", "xor", "test", "shl", "shr"};
+
+    int kind = randomNumber(20);
+    if (kind == 0)
+        return noOperand[randomNumber(3)];
+    if (kind < 3)
+        return string(oneRegister[randomNumber(4)]) + " " + randomRegister();
+    if (kind < 6)
+        return string(twoRegisters[randomNumber(12)]) + " " + randomRegister() + ", " + randomRegister();
+    if (kind < 11)
+        return jumpInstruction(options);
+    return loadStoreInstruction(options);
+}
+
+string wordDirective(const GeneratorOptions &options)
+{
+    string line = ".word ";
+    int count = 1 + randomNumber(4);
+    for (int i = 0; i < count; i++)
+    {
+        line += (i > 0 ? ", " : "") + randomValue(options);
+    }
+    return line;
+}
+
+bool parseMix(string mix, GeneratorOptions &options)
+{
+    size_t start = 0;
+    while (start < mix.size())
+    {
+        size_t end = mix.find(',', start);
+        end = end == string::npos ? mix.size() : end;
+        string item = mix.substr(start, end - start);
+        size_t colon = item.find(':');
+        if (colon == string::npos)
+            return false;
+
+        string mode = item.substr(0, colon);
+        int weight = atoi(item.substr(colon + 1).c_str());
+        if (mode == "imm")
+            options.immediate = weight;
+        else if (mode == "mem")
+            options.memory = weight;
+        else if (mode == "pcrel")
+            options.pcRelative = weight;
+        else if (mode == "reg")
+            options.registerDirect = weight;
+        else if (mode == "regind")
+            options.registerIndirect = weight;
+        else if (mode == "displ")
+            options.displacement = weight;
+        else
+            return false;
+        start = end + 1;
+    }
+    return options.immediate + options.memory + options.pcRelative + options.registerDirect + options.registerIndirect + options.displacement > 0;
+}
+
+int main(int argc, const char *argv[])
+{
+    GeneratorOptions options;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        string argument = argv[i], value = argv[i + 1];
+        if (argument == "--lines")
+            options.lines = atoi(value.c_str());
+        else if (argument == "--symbols")
+            options.symbols = atoi(value.c_str());
+        else if (argument == "--sections")
+            options.sections = atoi(value.c_str());
+        else if (argument == "--externs")
+            options.externs = atoi(value.c_str());
+        else if (argument == "--word-density")
+            options.wordDensity = atof(value.c_str());
+        else if (argument == "--seed")
+            options.seed = atoi(value.c_str());
+        else if (argument != "--mix" || !parseMix(value, options))
+        {
+            cerr << "Bad generator option: " << argument << " " << value << endl;
+            return 1;
+        }
+    }
+    options.sections = options.sections > 0 ? options.sections : 1;
+    options.symbols = options.symbols > 0 ? options.symbols : 1;
+    generator.seed(options.seed);
+
+    string out;
+    out += "# generated: lines=" + to_string(options.lines) + " symbols=" + to_string(options.symbols) +
+           " sections=" + to_string(options.sections) + " seed=" + to_string(options.seed) + "\n";
+    for (int i = 0; i < options.externs; i++)
+    {
+        out += (i % 8 == 0 ? (i > 0 ? "\n.extern " : ".extern ") : ",") + string("ext") + to_string(i);
+    }
+    out += options.externs > 0 ? "\n" : "";
+    out += ".global label0\n.equ limit, 0x7F\n";
+
+    // labels and lines are spread evenly over the sections, every label is defined once
+    int label = 0;
+    for (int section = 0; section < options.sections; section++)
+    {
+        out += "\n.section section" + to_string(section) + "\n";
+        int firstLine = (long long)options.lines * section / options.sections;
+        int lastLine = (long long)options.lines * (section + 1) / options.sections;
+        int lastLabel = (long long)options.symbols * (section + 1) / options.sections;
+
+        for (int line = firstLine; line < lastLine; line++)
+        {
+            int labelsLeft = lastLabel - label;
+            if (labelsLeft > 0 && randomNumber(lastLine - line) < labelsLeft)
+            {
+                out += "label" + to_string(label++) + ":\n";
+            }
+
+            int shape = randomNumber(100);
+            if (shape < 4)
+                out += "\n";
+            else if (shape < 8)
+                out += "# " + to_string(line) + "\n";
+            else if (shape < 9)
+                out += "    .skip " + to_string(1 + randomNumber(16)) + "\n";
+            else if (randomNumber(1000) < options.wordDensity * 1000)
+                out += "    " + wordDirective(options) + "\n";
+            else
+                out += (randomNumber(4) == 0 ? "\t" : "    ") + instruction(options) + (shape < 20 ? "    # comment\n" : "\n");
+
+            if (out.size() > (1 << 20))
+            {
+                cout << out;
+                out.clear();
+            }
+        }
+        while (label < lastLabel)
+        {
+            out += "label" + to_string(label++) + ":\n";
+        }
+    }
+    out += ".end\n";
+    cout << out;
+    return 0;
+}
@@ -0,0 +1,66 @@
+#!/bin/bash
+
+# Throughput benchmark: generates sources of different shapes, assembles each one in a
+# separate process and prints one JSON object per line, so two runs can be diffed.
+# The symbol_scaling series grows only the number of labels, to show the symbol table cost.
+# Usage: benchmark/run_benchmark.sh [scale]    (scale multiplies the line and symbol counts)
+
+SCALE=${1:-1}
+BENCH_DIR=$(dirname $0)
+WORK_DIR=$(mktemp -d)
+trap "rm -rf $WORK_DIR" EXIT
+
+# name lines symbols sections word-density mix
+CONFIGS="
+baseline         50000   5000   4  0.10 imm:3,mem:2,pcrel:2,reg:2,regind:1,displ:1
+many_lines       200000  5000   4  0.10 imm:3,mem:2,pcrel:2,reg:2,regind:1,displ:1
+many_symbols     50000   40000  4  0.10 imm:3,mem:2,pcrel:2,reg:2,regind:1,displ:1
+many_sections    50000   5000   64 0.10 imm:3,mem:2,pcrel:2,reg:2,regind:1,displ:1
+word_heavy       50000   5000   4  0.60 imm:3,mem:2,pcrel:2,reg:2,regind:1,displ:1
+symbolic_modes   50000   5000   4  0.10 imm:1,mem:4,pcrel:4,reg:0,regind:0,displ:1
+register_modes   50000   5000   4  0.10 imm:0,mem:0,pcrel:0,reg:4,regind:3,displ:1
+"
+
+echo "$CONFIGS" | while read name lines symbols sections density mix; do
+    [ -z "$name" ] && continue
+    lines=$(( lines * SCALE ))
+    symbols=$(( symbols * SCALE ))
+    $BENCH_DIR/source_generator --lines $lines --symbols $symbols --sections $sections \
+        --word-density $density --mix $mix --seed 1 > $WORK_DIR/$name.s
+    $BENCH_DIR/assembler_benchmark $WORK_DIR/$name.s $WORK_DIR/$name.o --name $name
+    $BENCH_DIR/assembler_benchmark $WORK_DIR/$name.s $WORK_DIR/$name.o --name $name.binary --format=binary
+done
+
+field() { sed -n "s/.*\"$1\": \([0-9.]*\).*/\1/p"; }
+
+# every label is referenced from an instruction and a .word, the references jump around the table
+for count in 1000 2000 4000 8000 16000 32000; do
+    count=$(( count * SCALE ))
+    awk -v n=$count 'BEGIN {
+        print ".global label0"
+        print ".section code"
+        for (i = 0; i < n; i++) {
+            printf "label%d:\n", i
+            printf "    ldr r1, label%d\n", (i * 7919) % n
+            printf "    jmp label%d\n", i
+        }
+        print ".section data"
+        for (i = 0; i < n; i++) {
+            printf "    .word label%d\n", i
+        }
+        print ".end"
+    }' > $WORK_DIR/symbols.s
+    result=$($BENCH_DIR/assembler_benchmark $WORK_DIR/symbols.s $WORK_DIR/symbols.o --name symbol_scaling_$count)
+    perSymbol=$(awk -v t=$(echo "$result" | field total_ms) -v n=$count 'BEGIN { printf "%.3f", t * 1000 / n }')
+    echo "${result%\}}, \"symbols\": $count, \"us_per_symbol\": $perSymbol}"
+done
+
+# allocation check: the same shape at four times the size has to stay within the
+# allocations per line of the small run, i.e. no line allocates on its own
+$BENCH_DIR/source_generator --lines $(( 50000 * SCALE )) --symbols $(( 5000 * SCALE )) --seed 1 > $WORK_DIR/small.s
+$BENCH_DIR/source_generator --lines $(( 200000 * SCALE )) --symbols $(( 20000 * SCALE )) --seed 1 > $WORK_DIR/large.s
+small=$($BENCH_DIR/assembler_benchmark $WORK_DIR/small.s $WORK_DIR/small.o | field allocations_per_line)
+large=$($BENCH_DIR/assembler_benchmark $WORK_DIR/large.s $WORK_DIR/large.o | field allocations_per_line)
+constant=$(awk -v s="$small" -v l="$large" 'BEGIN { print (l <= s * 1.1 + 0.01) ? "true" : "false" }')
+echo "{\"name\": \"allocation_scaling\", \"small_allocations_per_line\": $small, \"large_allocations_per_line\": $large, \"constant\": $constant}"
+[ "$constant" = "true" ]
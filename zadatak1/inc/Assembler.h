@@ -0,0 +1,40 @@
+#ifndef ASSEMBLER_H
+#define ASSEMBLER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Parser.h"
+#include "ObjectFile.h"
+
+using namespace std;
+
+struct AssemblerResult
+{
+    bool success;
+    // set when the input file could not be opened, there are no diagnostics then
+    bool inputError;
+    ObjectFile object;
+    vector<Parser::Diagnostic> diagnostics;
+    AssemblerResult() : success(false), inputError(false) {}
+};
+
+// Library entry point. Every call assembles with a fresh parser, so one Assembler can be
+// used for any number of inputs and separate Assemblers can run on separate threads.
+class Assembler
+{
+private:
+    bool onePass;
+
+    void run(Parser *parser, AssemblerResult &result);
+
+public:
+    Assembler();
+    ~Assembler();
+    void setOnePass(bool enabled);
+    AssemblerResult assembleFile(const string &filePath);
+    AssemblerResult assembleSource(string_view source);
+};
+
+#endif
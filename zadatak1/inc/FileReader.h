@@ -4,6 +4,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 
 using namespace std;
 
@@ -13,12 +14,26 @@ private:
     ifstream file;
     bool endOfFile;
 
+    // regular files are mapped and read in place, anything else (pipes, terminals) is streamed
+    const char *mapping;
+    bool ownsMapping;
+    size_t mappingSize;
+    size_t position;
+    string streamLine, streamContents;
+
+    void mapFile(const string &filePath);
+
 public:
-    FileReader(string filePath);
+    FileReader(const string &filePath);
+    FileReader(const char *source, size_t size);
     ~FileReader();
     string getNextLine();
+    void getNextLine(string &line);
+    void getNextLine(string_view &line);
     bool isFileOpened();
     bool isEndOfFile();
+    bool isMapped();
+    string_view getContents();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -4,26 +4,44 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <iomanip>
+#include <string_view>
 #include <vector>
 
+#include "ObjectFormat.h"
+
 using namespace std;
 
 class FileWriter
 {
 private:
+    static const size_t BUFFER_SIZE = 1 << 20;
+
     ofstream file;
+    string buffer;
+    size_t flushedBytes;
+    // integers without a fixed width follow the base of the previous line, like the
+    // sticky hex flag of the stream this writer replaced
+    bool hexMode;
+
+    void append(string_view text);
+    void appendHex(unsigned int value, int width);
+    void appendNumber(int value);
+    void flushIfFull();
+    void flush();
 
 public:
-    FileWriter(string filePath);
+    FileWriter(const string &filePath);
     ~FileWriter();
-    void writeLine(string line);
+    void writeLine(string_view line);
     void addNewLine();
-    void writeSection(int sectionId, string sectionName, int sectionSize);
-    void writeSymbol(int offset, bool isLocal, bool isDefined, bool isExtern, string section, string name, int symbolId);
-    void writeRelocationValue(int offset, string type, bool isData, string symbolName, string sectionName);
-    void writeSectionData(vector<int> offsets, vector<char> data);
+    void writeSection(int sectionId, string_view sectionName, int sectionSize);
+    void writeSymbol(int offset, bool isLocal, bool isDefined, bool isExtern, string_view section, string_view name, int symbolId);
+    void writeRelocationValue(int offset, string_view type, bool isData, string_view symbolName, string_view sectionName);
+    void writeSectionData(const vector<int> &offsets, const vector<char> &data, const vector<ObjectZeroFill> &zeroFills);
     void changeToDec();
+    void writeBytes(const void *data, size_t size);
+    bool isFileOpened();
+    size_t getBytesWritten();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,136 @@
+#ifndef INSTRUCTION_TABLE_H
+#define INSTRUCTION_TABLE_H
+
+#include <cstdint>
+#include <string_view>
+
+using namespace std;
+
+// Every mnemonic of the instruction set with the bytes it encodes to. Mnemonics are
+// found through a perfect hash that the compiler builds: it searches for a seed that
+// puts every mnemonic in its own slot, so a lookup is one hash and one compare.
+
+enum InstructionShape : uint8_t
+{
+    NO_OPERAND_SHAPE,
+    REGISTER_SHAPE,
+    TWO_REGISTER_SHAPE,
+    JUMP_SHAPE,
+    LOAD_STORE_SHAPE
+};
+
+// size is the longest encoding, jumps and loads/stores with a register operand take 3 bytes;
+// registerLow is the low nibble of the register byte and addressMode the third byte
+// of one register instructions
+struct InstructionInfo
+{
+    string_view mnemonic;
+    InstructionShape shape;
+    uint8_t opcode, size, registerLow, addressMode;
+};
+
+constexpr InstructionInfo INSTRUCTIONS[] = {
+    {"halt", NO_OPERAND_SHAPE, 0x00, 1, 0, 0},
+    {"iret", NO_OPERAND_SHAPE, 0x20, 1, 0, 0},
+    {"ret", NO_OPERAND_SHAPE, 0x40, 1, 0, 0},
+    {"int", REGISTER_SHAPE, 0x10, 2, 0xF, 0},
+    {"not", REGISTER_SHAPE, 0x80, 2, 0xF, 0},
+    {"push", REGISTER_SHAPE, 0xB0, 3, 0x6, 0x12},
+    {"pop", REGISTER_SHAPE, 0xA0, 3, 0x6, 0x42},
+    {"xchg", TWO_REGISTER_SHAPE, 0x60, 2, 0, 0},
+    {"add", TWO_REGISTER_SHAPE, 0x70, 2, 0, 0},
+    {"sub", TWO_REGISTER_SHAPE, 0x71, 2, 0, 0},
+    {"mul", TWO_REGISTER_SHAPE, 0x72, 2, 0, 0},
+    {"div", TWO_REGISTER_SHAPE, 0x73, 2, 0, 0},
+    {"cmp", TWO_REGISTER_SHAPE, 0x74, 2, 0, 0},
+    {"and", TWO_REGISTER_SHAPE, 0x81, 2, 0, 0},
+    {"or", TWO_REGISTER_SHAPE, 0x82, 2, 0, 0},
+    {"xor", TWO_REGISTER_SHAPE, 0x83, 2, 0, 0},
+    {"test", TWO_REGISTER_SHAPE, 0x84, 2, 0, 0},
+    {"shl", TWO_REGISTER_SHAPE, 0x90, 2, 0, 0},
+    {"shr", TWO_REGISTER_SHAPE, 0x91, 2, 0, 0},
+    {"call", JUMP_SHAPE, 0x30, 5, 0, 0},
+    {"jmp", JUMP_SHAPE, 0x50, 5, 0, 0},
+    {"jeq", JUMP_SHAPE, 0x51, 5, 0, 0},
+    {"jne", JUMP_SHAPE, 0x52, 5, 0, 0},
+    {"jgt", JUMP_SHAPE, 0x53, 5, 0, 0},
+    {"ldr", LOAD_STORE_SHAPE, 0xA0, 5, 0, 0},
+    {"str", LOAD_STORE_SHAPE, 0xB0, 5, 0, 0}};
+
+constexpr int INSTRUCTION_COUNT = sizeof(INSTRUCTIONS) / sizeof(INSTRUCTIONS[0]);
+constexpr size_t MAX_MNEMONIC_LENGTH = 4;
+constexpr int MNEMONIC_SLOT_BITS = 7;
+
+constexpr uint32_t mnemonicHash(string_view mnemonic, uint32_t seed)
+{
+    uint32_t hash = seed;
+    for (size_t i = 0; i < mnemonic.size(); i++)
+    {
+        hash = (hash ^ (unsigned char)mnemonic[i]) * 0x01000193u;
+    }
+    return hash >> (32 - MNEMONIC_SLOT_BITS);
+}
+
+constexpr bool isPerfectSeed(uint32_t seed)
+{
+    bool used[1 << MNEMONIC_SLOT_BITS] = {};
+    for (int i = 0; i < INSTRUCTION_COUNT; i++)
+    {
+        uint32_t slot = mnemonicHash(INSTRUCTIONS[i].mnemonic, seed);
+        if (used[slot])
+        {
+            return false;
+        }
+        used[slot] = true;
+    }
+    return true;
+}
+
+constexpr uint32_t findPerfectSeed()
+{
+    uint32_t seed = 1;
+    while (!isPerfectSeed(seed))
+    {
+        seed++;
+    }
+    return seed;
+}
+
+struct MnemonicSlots
+{
+    int8_t instruction[1 << MNEMONIC_SLOT_BITS];
+};
+
+constexpr uint32_t MNEMONIC_SEED = findPerfectSeed();
+
+constexpr MnemonicSlots buildMnemonicSlots()
+{
+    MnemonicSlots slots = {};
+    for (int slot = 0; slot < (1 << MNEMONIC_SLOT_BITS); slot++)
+    {
+        slots.instruction[slot] = -1;
+    }
+    for (int i = 0; i < INSTRUCTION_COUNT; i++)
+    {
+        slots.instruction[mnemonicHash(INSTRUCTIONS[i].mnemonic, MNEMONIC_SEED)] = i;
+    }
+    return slots;
+}
+
+constexpr MnemonicSlots MNEMONIC_SLOTS = buildMnemonicSlots();
+
+// nullptr when the text is not a mnemonic
+constexpr const InstructionInfo *findInstruction(string_view mnemonic)
+{
+    if (mnemonic.empty() || mnemonic.size() > MAX_MNEMONIC_LENGTH)
+    {
+        return nullptr;
+    }
+    int index = MNEMONIC_SLOTS.instruction[mnemonicHash(mnemonic, MNEMONIC_SEED)];
+    return index >= 0 && INSTRUCTIONS[index].mnemonic == mnemonic ? &INSTRUCTIONS[index] : nullptr;
+}
+
+static_assert(findInstruction("shr") == &INSTRUCTIONS[18] && findInstruction("jmp") == &INSTRUCTIONS[20], "mnemonic lookup");
+static_assert(findInstruction("jmpx") == nullptr && findInstruction("psw") == nullptr, "mnemonic lookup");
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef LINE_SCANNER_H
+#define LINE_SCANNER_H
+
+#include <string>
+#include <string_view>
+
+#include "InstructionTable.h"
+
+using namespace std;
+
+class LineScanner
+{
+private:
+    unsigned long callCount;
+
+    bool isLetter(char c);
+    bool isDigit(char c);
+    bool startsWith(string_view text, string_view prefix);
+    bool hasLineBreak(string_view text);
+    size_t symbolLength(string_view text);
+    bool isDecimal(string_view text);
+    bool isHexaDecimal(string_view text);
+    bool isSymbolOrLiteral(string_view text);
+    bool isRegister(string_view text);
+    bool isSymbolList(string_view text, string_view &lastItem);
+    bool isOperandList(string_view text, string_view &firstItem);
+    size_t registerLength(string_view text);
+    bool splitIndirect(string_view text, string_view &reg, string_view &displacement, bool &hasDisplacement);
+    bool isTrimOnly(string_view line, size_t &first, size_t &last);
+
+public:
+    enum DirectiveType
+    {
+        GLOBAL,
+        EXTERNAL,
+        SECTION,
+        WORD,
+        SKIP,
+        EQU,
+        END,
+        LABEL,
+        LABEL_WITH_INSTRUCTION,
+        INSTRUCTION
+    };
+
+    struct Directive
+    {
+        string_view param1, param2;
+        DirectiveType type;
+        Directive(string_view p1, string_view p2, DirectiveType t) : param1(p1), param2(p2), type(t) {}
+    };
+
+    enum InstructionType
+    {
+        NO_OPERAND,
+        ONE_OPERAND,
+        TWO_OPERAND,
+        ONE_OPERAND_JUMP,
+        TWO_OPERAND_LOAD_STORE,
+        BAD_INSTRUCTION
+    };
+
+    struct Instruction
+    {
+        string_view param1, param2, param3;
+        InstructionType type;
+        const InstructionInfo *info;
+        Instruction(string_view p1, string_view p2, string_view p3, InstructionType t, const InstructionInfo *i = nullptr) : param1(p1), param2(p2), param3(p3), type(t), info(i) {}
+    };
+
+    enum JumpType
+    {
+        JUMP_ABS,
+        JUMP_MEM_DIR,
+        JUMP_PC_RELATIVE,
+        JUMP_REG_DIR,
+        JUMP_REG_IND,
+        JUMP_REG_IND_DISPL,
+        BAD_JUMP
+    };
+
+    struct Jump
+    {
+        string_view param1, param2;
+        JumpType type;
+        Jump(string_view p1, string_view p2, JumpType t) : param1(p1), param2(p2), type(t) {}
+    };
+
+    enum LoadStoreType
+    {
+        LOAD_STORE_ABS_SYMBOL,
+        LOAD_STORE_ABS_VALUE,
+        LOAD_STORE_MEM_DIR_SYMBOL,
+        LOAD_STORE_MEM_DIR_VALUE,
+        LOAD_STORE_PC_RELATIVE,
+        LOAD_STORE_REG_DIR,
+        LOAD_STORE_REG_IND,
+        LOAD_STORE_REG_IND_DISPL_SYMBOL,
+        LOAD_STORE_REG_IND_DISPL_VALUE,
+        BAD_LOAD_STORE
+    };
+
+    struct LoadStore
+    {
+        string_view param1, param2;
+        LoadStoreType type;
+        LoadStore(string_view p1, string_view p2, LoadStoreType t) : param1(p1), param2(p2), type(t) {}
+    };
+
+    enum LiteralType
+    {
+        DECIMAL,
+        HEXA_DECIMAL,
+        ERROR
+    };
+
+    struct Literal
+    {
+        string_view param1;
+        LiteralType type;
+        Literal(string_view p1, LiteralType t) : param1(p1), type(t) {}
+    };
+
+    Directive searchLine(string_view line);
+    Instruction searchInstruction(string_view line);
+    Jump searchJump(string_view operand);
+    LoadStore searchLoadStore(string_view operand);
+    Literal searchLiteral(string_view literal);
+    bool isSymbol(string_view operand);
+    void normalizeLine(string &line);
+    string_view normalizeLine(string_view line, string &buffer);
+    unsigned long getCallCount();
+    LineScanner();
+    ~LineScanner();
+};
+
+#endif
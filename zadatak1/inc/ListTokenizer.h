@@ -0,0 +1,21 @@
+#ifndef LIST_TOKENIZER_H
+#define LIST_TOKENIZER_H
+
+#include <string_view>
+
+using namespace std;
+
+// Walks a comma separated list without copying it: every item is a view into the
+// list, split the way getline(stream, item, ',') splits it.
+class ListTokenizer
+{
+private:
+    string_view list;
+    size_t position;
+
+public:
+    ListTokenizer(string_view text);
+    bool next(string_view &item);
+};
+
+#endif
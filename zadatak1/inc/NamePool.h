@@ -0,0 +1,34 @@
+#ifndef NAME_POOL_H
+#define NAME_POOL_H
+
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
+#include "StringArena.h"
+
+using namespace std;
+
+// Interned symbol and section names: every distinct name is stored once and is
+// known by its handle, so names are compared as integers. Handle 0 is the empty name.
+class NamePool
+{
+private:
+    StringArena *arena;
+    vector<string_view> names;
+    unordered_map<string_view, int> index;
+
+public:
+    static const int EMPTY = 0;
+    static const int NOT_FOUND = -1;
+
+    NamePool();
+    ~NamePool();
+    int intern(string_view name);
+    int find(string_view name);
+    string_view getName(int handle);
+    int countProbes(string_view name);
+    int size();
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef OBJECT_FILE_H
+#define OBJECT_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ObjectFormat.h"
+
+using namespace std;
+
+// In memory form of the binary object file. Section data offsets are relative to
+// data here, serialize turns them into file offsets and parse turns them back.
+class ObjectFile
+{
+public:
+    vector<ObjectSection> sections;
+    vector<ObjectSymbol> symbols;
+    vector<ObjectRelocation> relocations;
+    vector<ObjectZeroFill> zeroFills;
+    string stringTable;
+    vector<char> data;
+
+    ObjectFile();
+    ~ObjectFile();
+    uint32_t addString(string_view name);
+    string_view getString(uint32_t offset) const;
+    void getSectionBytes(const ObjectSection &section, vector<char> &bytes) const;
+    void serialize(string &bytes) const;
+    bool write(const string &filePath) const;
+    bool parse(string_view bytes);
+    bool read(const string &filePath);
+};
+
+#endif
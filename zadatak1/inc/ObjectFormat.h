@@ -0,0 +1,98 @@
+#ifndef OBJECT_FORMAT_H
+#define OBJECT_FORMAT_H
+
+#include <cstdint>
+
+// Binary relocatable object file. Every field is little endian and every table is
+// naturally aligned, so a consumer can mmap the file and use these structs in place.
+//
+//   ObjectHeader
+//   ObjectSection[sectionCount]
+//   ObjectSymbol[symbolCount]
+//   ObjectRelocation[relocationCount]    grouped by section, in section table order
+//   ObjectZeroFill[zeroFillCount]         grouped by section, in offset order
+//   string table                          zero terminated names, referenced by offset
+//   section data                          stored bytes of every section
+//
+// A section is size bytes long: its stored bytes with the zero fill spans (.skip)
+// inserted between them, so a span takes no room in the file.
+
+const uint32_t OBJECT_MAGIC = 0x4a424f48; // "HOBJ"
+const uint16_t OBJECT_VERSION = 2;
+
+enum ObjectSymbolType : uint8_t
+{
+    OBJECT_SYMBOL_LOCAL = 'l',
+    OBJECT_SYMBOL_GLOBAL = 'g',
+    OBJECT_SYMBOL_EXTERN = 'e',
+    OBJECT_SYMBOL_UNDEFINED = 'u'
+};
+
+enum ObjectRelocationType : uint8_t
+{
+    OBJECT_R_H_16 = 0,
+    OBJECT_R_H_16_PC = 1
+};
+
+const int32_t OBJECT_NO_SYMBOL = -1;
+
+// the assembler puts these two first in the section table, extern symbols point at the undefined one
+const uint32_t OBJECT_UNDEFINED_SECTION = 0;
+const uint32_t OBJECT_ABSOLUTE_SECTION = 1;
+
+struct ObjectHeader
+{
+    uint32_t magic;
+    uint16_t version, reserved;
+    uint32_t sectionCount, sectionTableOffset;
+    uint32_t symbolCount, symbolTableOffset;
+    uint32_t relocationCount, relocationTableOffset;
+    uint32_t zeroFillCount, zeroFillTableOffset;
+    uint32_t stringTableSize, stringTableOffset;
+    uint32_t dataSize, dataOffset;
+};
+
+struct ObjectSection
+{
+    int32_t id;
+    uint32_t name;
+    uint32_t size;
+    uint32_t dataSize, dataOffset;
+    uint32_t relocationCount, firstRelocation;
+    uint32_t zeroFillCount, firstZeroFill;
+};
+
+struct ObjectSymbol
+{
+    uint32_t name;
+    int32_t value;
+    int32_t section;
+    int32_t id;
+    uint8_t type;
+    uint8_t reserved[3];
+};
+
+struct ObjectRelocation
+{
+    uint32_t offset;
+    int32_t symbol;
+    uint8_t type;
+    uint8_t isData;
+    int16_t addend;
+};
+
+// size zero bytes at section offset, the stored bytes continue at dataOffset of the section data
+struct ObjectZeroFill
+{
+    uint32_t offset;
+    uint32_t size;
+    uint32_t dataOffset;
+};
+
+static_assert(sizeof(ObjectHeader) == 56, "object header layout");
+static_assert(sizeof(ObjectSection) == 36, "object section layout");
+static_assert(sizeof(ObjectSymbol) == 20, "object symbol layout");
+static_assert(sizeof(ObjectRelocation) == 12, "object relocation layout");
+static_assert(sizeof(ObjectZeroFill) == 12, "object zero fill layout");
+
+#endif
@@ -3,20 +3,56 @@
 
 #include <iostream>
 #include <vector>
-#include <regex>
+#include <map>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <chrono>
+#include <atomic>
 
-#include "RegexWrapper.h"
+#include "LineScanner.h"
+#include "ObjectFile.h"
+#include "FileReader.h"
+#include "StringArena.h"
+#include "NamePool.h"
+#include "WorkerPool.h"
 
 using namespace std;
 
 class Parser
 {
-private:
-    static Parser *instance;
+public:
+    enum OutputFormat
+    {
+        TEXT,
+        BINARY
+    };
+    enum Status
+    {
+        SUCCESS,
+        INPUT_ERROR,
+        ASSEMBLY_ERROR
+    };
+    struct Diagnostic
+    {
+        int lineNumber;
+        string message;
+        Diagnostic(int l, string m) : lineNumber(l), message(m) {}
+    };
+    // wall time of every compile phase in milliseconds (one pass mode counts everything
+    // as first pass) and the work counters behind them
+    struct Statistics
+    {
+        double cleanupTime, firstPassTime, secondPassTime, outputTime;
+        int linesBeforeCleanup, linesAfterCleanup;
+        unsigned long scannerCalls, symbolLookups, symbolProbes, bytesWritten;
+        Statistics() : cleanupTime(0), firstPassTime(0), secondPassTime(0), outputTime(0), linesBeforeCleanup(0), linesAfterCleanup(0),
+                       scannerCalls(0), symbolLookups(0), symbolProbes(0), bytesWritten(0) {}
+    };
 
-    static int symbolId;
-    static int sectionId;
+private:
+    int symbolId;
+    int sectionId;
 
     const string UNDEFINED = "UNDEFINED";
     const string ABSOLUTE = "ABSOLUTE";
@@ -24,100 +60,202 @@ private:
     const string R_H_16 = "R_H_16";
     const string R_H_16_PC = "R_H_16_PC";
 
-    const string HALT = "halt";
-    const string IRET = "iret";
-    const string RET = "ret";
-
-    const string PSW = "psw";
-    const string INT = "int";
-    const string NOT = "not";
-    const string PUSH = "push";
-    const string POP = "pop";
-
-    const string CALL = "call";
-    const string JMP = "jmp";
-    const string JEQ = "jeq";
-    const string JNE = "jne";
-    const string JGT = "jgt";
-
-    const string LDR = "ldr";
-    const string STR = "str";
-
-    const string XCHG = "xchg";
-    const string ADD = "add";
-    const string SUB = "sub";
-    const string MUL = "mul";
-    const string DIV = "div";
-    const string CMP = "cmp";
-    const string AND = "and";
-    const string OR = "or";
-    const string XOR = "xor";
-    const string TEST = "test";
-    const string SHL = "shl";
-    const string SHR = "shr";
-
+    // messages are string literals, so an error costs no allocation
     struct AssemblerError
     {
-        string message;
+        const char *message;
         int lineNumber;
-        AssemblerError(string m, int l) : message(m), lineNumber(l) {}
+        AssemblerError(const char *m, int l) : message(m), lineNumber(l) {}
     };
+    // section and symbol names are handles into the name pool
     struct Symbol
     {
         int symbolId, offset;
         bool isLocal, isDefined, isExtern;
-        string section, name;
-        Symbol(int id, int o, bool local, bool defined, bool ex, string s, string n) : symbolId(id), offset(o), isLocal(local), isDefined(defined), isExtern(ex), section(s), name(n) {}
+        int section, name;
+        Symbol(int id, int o, bool local, bool defined, bool ex, int s, int n) : symbolId(id), offset(o), isLocal(local), isDefined(defined), isExtern(ex), section(s), name(n) {}
     };
     struct Section
     {
         int sectionId, sectionSize;
-        string sectionName;
+        int name;
+        // index of the section symbol, relocations against the section use it
+        int symbol;
         vector<char> data;
         vector<int> offsets;
-        Section(int id, int size, string name) : sectionId(id), sectionSize(size), sectionName(name) {}
+        // relocations refer to symbols by their index in the symbol table
+        vector<ObjectRelocation> relocations;
+        vector<ObjectZeroFill> zeroFills;
+        Section(int id, int size, int n, int sym) : sectionId(id), sectionSize(size), name(n), symbol(sym) {}
     };
-    struct RelocationValue
+
+    enum OperandType
+    {
+        NONE,
+        LITERAL,
+        SYMBOL,
+        PC_RELATIVE_SYMBOL
+    };
+    // text points into the decoded line and is only read until the symbol is interned
+    struct Operand
+    {
+        OperandType type;
+        int value, symbol;
+        string_view text;
+        Operand() : type(NONE), value(0), symbol(NamePool::EMPTY) {}
+        Operand(OperandType t, int v, string_view s) : type(t), value(v), symbol(NamePool::EMPTY), text(s) {}
+    };
+
+    // first pass decodes every line that emits or switches sections into this record,
+    // second pass only resolves symbols and writes the bytes
+    enum LineType
+    {
+        SECTION_LINE,
+        SKIP_LINE,
+        WORD_LINE,
+        INSTRUCTION_LINE
+    };
+    struct DecodedLine
+    {
+        LineType type;
+        int lineNumber, offset;
+        unsigned char instrDescr, regDescr, adrMode, size;
+        Operand operand;
+        int firstWord, wordCount;
+        const char *error;
+        DecodedLine(LineType t, int l, int o) : type(t), lineNumber(l), offset(o), instrDescr(0), regDescr(0), adrMode(0), size(0), firstWord(0), wordCount(0), error(nullptr) {}
+    };
+    // syntax of one cleaned line, found without looking at any other line: label holds
+    // the classification of the whole line, directive the one after a label
+    struct ScannedLine
     {
+        LineScanner::Directive label, directive;
+        DecodedLine instruction;
+        bool isInstruction;
+        ScannedLine() : label("", "", LineScanner::INSTRUCTION), directive("", "", LineScanner::INSTRUCTION), instruction(INSTRUCTION_LINE, 0, 0), isInstruction(false) {}
+    };
+    // a piece of the input that is cleaned on its own, lines never cross chunk borders
+    struct CleanupChunk
+    {
+        string_view text;
+        int rawLines;
+        vector<string_view> lines;
+        vector<int> rawLineNumbers;
+        StringArena *arena;
+        unsigned long scannerCalls;
+        CleanupChunk(string_view t) : text(t), rawLines(0), arena(nullptr), scannerCalls(0) {}
+    };
+    // one pass mode: symbol operand that is patched when the whole source is read
+    struct Fixup
+    {
+        Operand operand;
         bool isData;
-        string sectionName, type, symbolName;
-        int offset, addend;
-        RelocationValue(bool data, string section, string t, string symbol, int o, int a) : isData(data), sectionName(section), type(t), symbolName(symbol), offset(o), addend(a) {}
+        int section, locationCounter, lineNumber;
+        Fixup(const Operand &o, bool data, int s, int lc, int l) : operand(o), isData(data), section(s), locationCounter(lc), lineNumber(l) {}
+    };
+    // second pass state of one section: sections are encoded independently and their
+    // bytes, relocations and errors are committed to the tables in a fixed order
+    struct SectionEncoder
+    {
+        int section, locationCounter, currentLine;
+        vector<int> lines;
+        vector<char> data;
+        vector<int> offsets;
+        vector<ObjectZeroFill> zeroFills;
+        vector<ObjectRelocation> relocations;
+        vector<AssemblerError> errors;
+        SectionEncoder(int s) : section(s), locationCounter(0), currentLine(0) {}
     };
 
-    string inputFilePath, outputFilePath, currentSection;
-    int currentLine, locationCounter;
-    vector<string> inputFileWithClearedLines;
+    string inputFilePath, outputFilePath;
+    string_view inputSource;
+    bool hasInputSource;
+    int currentSection, activeSection, currentLine, locationCounter;
+    bool onePass, reachedEnd;
+    OutputFormat outputFormat;
+    Statistics statistics;
+    bool collectStatistics;
+    // cleaned lines are views into the mapped input, or into textArena when cleanup changed them
+    vector<string_view> inputFileWithClearedLines;
+    FileReader *inputFile;
+    NamePool *names;
+    int undefinedName, absoluteName;
     vector<AssemblerError> errors;
     vector<Symbol> symbolTable;
+    // symbol table index of the first symbol with a given name handle, -1 for none
+    vector<int> symbolIndex;
+    // section table index of a name handle; a name has at most one section
+    vector<int> sectionIndex;
     vector<Section> sectionTable;
-    vector<RelocationValue> relocationTable;
-    map<int, int> lineNumberBeforeProcessing;
-    RegexWrapper *regexWrapper;
+    vector<DecodedLine> decodedLines;
+    vector<Operand> wordOperands;
+    vector<Fixup> fixups;
+    vector<int> lineNumberBeforeProcessing;
+    LineScanner *lineScanner;
+    WorkerPool *workerPool;
+    vector<StringArena *> chunkArenas;
+    unsigned long parallelScannerCalls;
+    atomic<unsigned long> symbolLookups, symbolProbes;
 
     bool removeBlankLinesComments();
     bool firstPass();
     bool secondPass();
-    void addError(string message, int lineNumber);
-    void addSymbol(int o, bool local, bool defined, bool ext, string s, string n);
-    void addSection(int s, string n);
-    void addRelocationValue(bool data, string section, string t, string symbol, int o, int a);
-    int convertToDecimalValueFromLiteral(string literal);
-    void increaseSectionSizeAndCounter(int size, string name);
-    void printErrors();
-    void createTxtFile();
-    bool handleLabel(string symbolName);
+    Status assembleInOnePass();
+    FileReader *openInput();
+    void runTasks(int count, const function<void(int)> &task);
+    void cleanupChunk(CleanupChunk &chunk);
+    void scanLine(LineScanner *scanner, string_view line, ScannedLine &scanned);
+    void decodeLine(string_view line, bool &hasError);
+    void decodeLine(const ScannedLine &scanned, bool &hasError);
+    bool encodeLine(const DecodedLine &decoded, SectionEncoder &encoder);
+    void commitEncoder(SectionEncoder &encoder);
+    bool decodeInstruction(LineScanner *scanner, string_view line, DecodedLine &decoded);
+    bool decodeJump(LineScanner *scanner, const InstructionInfo *info, string_view operand, DecodedLine &decoded);
+    bool decodeLoadStore(LineScanner *scanner, const InstructionInfo *info, string_view regD, string_view operand, DecodedLine &decoded);
+    Operand decodeOperand(LineScanner *scanner, string_view operand, const char *&error);
+    int decodeRegister(string_view reg);
+    bool resolveOperand(const Operand &operand, int &value, SectionEncoder &encoder);
+    bool resolveWordOperand(const Operand &word, int &value, SectionEncoder &encoder);
+    void addFixup(const Operand &operand, bool isData, SectionEncoder &encoder);
+    bool resolveFixups();
+    void patchCurrentSection(int position, char first, char second);
+    void addError(const char *message, int lineNumber);
+    void addSymbol(int o, bool local, bool defined, bool ext, int s, int n);
+    int internName(string_view name);
+    void internOperand(Operand &operand);
+    Symbol *findSymbol(int name);
+    void countSymbolProbes(string_view name);
+    void addSection(int s, int n);
+    int findSection(int name);
+    void addRelocationValue(SectionEncoder &encoder, bool data, ObjectRelocationType t, int symbol, int o, int a);
+    int sectionSymbol(int name);
+    bool parseLiteral(LineScanner *scanner, string_view literal, int &number, const char *&error);
+    void increaseSectionSizeAndCounter(int size);
+    void printErrors(ostream &messages);
+    int sourceLineNumber(int lineNumber);
+    bool createTxtFile();
+    bool createBinaryFile();
+    bool handleLabel(string_view symbolName);
     void updateAbsoluteSection(int value);
-    void insertWordDataInCurrentSection(int value);
-    void insertJumpDataInCurrentSection(int instrDescr, int regDescr, int adrMode, int value, bool includeValue);
+    void insertWordDataInCurrentSection(SectionEncoder &encoder, int value);
+    void insertInstructionInCurrentSection(SectionEncoder &encoder, const DecodedLine &decoded, int value);
 
 public:
-    static Parser *getInstance();
-
+    // a parser assembles a single input, make a new one for the next
     Parser();
     ~Parser();
-    void setFilesPath(string iFile, string oFile);
-    void compile();
+    void setFilesPath(const string &iFile, const string &oFile);
+    void setSource(string_view source);
+    void setOnePass(bool enabled);
+    void setOutputFormat(OutputFormat format);
+    void setWorkerPool(WorkerPool *pool);
+    bool compile(ostream &messages = cout);
+    Status assemble();
+    void buildObjectFile(ObjectFile &object);
+    void getDiagnostics(vector<Diagnostic> &diagnostics);
+    void setCollectStatistics(bool enabled);
+    const Statistics &getStatistics();
+    void printStatistics(ostream &out, bool json);
 };
 
 #endif
@@ -3,6 +3,9 @@
 
 #include <regex>
 #include <string>
+#include <string_view>
+
+#include "LineScanner.h"
 
 using namespace std;
 
@@ -50,104 +53,15 @@ private:
     const regex regexLoadStoreRegInd = regex("^\\[(r[0-7]|psw)\\]$");
     const regex regexLoadStoreRegIndWithDisplacement = regex("^\\[(r[0-7]|psw) \\+ ([a-zA-Z][a-zA-Z0-9_]*|-?[0-9]+|0x[0-9A-F]+)\\]$");
 
-public:
-    enum DirectiveType
-    {
-        GLOBAL,
-        EXTERNAL,
-        SECTION,
-        WORD,
-        SKIP,
-        EQU,
-        END,
-        LABEL,
-        LABEL_WITH_INSTRUCTION,
-        INSTRUCTION
-    };
-
-    struct Directive
-    {
-        string param1, param2;
-        DirectiveType type;
-        Directive(string p1, string p2, DirectiveType t) : param1(p1), param2(p2), type(t) {}
-    };
-
-    enum InstructionType
-    {
-        NO_OPERAND,
-        ONE_OPERAND,
-        TWO_OPERAND,
-        ONE_OPERAND_JUMP,
-        TWO_OPERAND_LOAD_STORE,
-        BAD_INSTRUCTION
-    };
-
-    struct Instruction
-    {
-        string param1, param2, param3;
-        InstructionType type;
-        Instruction(string p1, string p2, string p3, InstructionType t) : param1(p1), param2(p2), param3(p3), type(t) {}
-    };
-
-    enum JumpType
-    {
-        JUMP_ABS,
-        JUMP_MEM_DIR,
-        JUMP_PC_RELATIVE,
-        JUMP_REG_DIR,
-        JUMP_REG_IND,
-        JUMP_REG_IND_DISPL,
-        BAD_JUMP
-    };
+    string_view view(const smatch &match, size_t index);
 
-    struct Jump
-    {
-        string param1, param2;
-        JumpType type;
-        Jump(string p1, string p2, JumpType t) : param1(p1), param2(p2), type(t) {}
-    };
-
-    enum LoadStoreType
-    {
-        LOAD_STORE_ABS_SYMBOL,
-        LOAD_STORE_ABS_VALUE,
-        LOAD_STORE_MEM_DIR_SYMBOL,
-        LOAD_STORE_MEM_DIR_VALUE,
-        LOAD_STORE_PC_RELATIVE,
-        LOAD_STORE_REG_DIR,
-        LOAD_STORE_REG_IND,
-        LOAD_STORE_REG_IND_DISPL_SYMBOL,
-        LOAD_STORE_REG_IND_DISPL_VALUE,
-        BAD_LOAD_STORE
-    };
-
-    struct LoadStore
-    {
-        string param1, param2;
-        LoadStoreType type;
-        LoadStore(string p1, string p2, LoadStoreType t) : param1(p1), param2(p2), type(t) {}
-    };
-
-    enum LiteralType
-    {
-        DECIMAL,
-        HEXA_DECIMAL,
-        ERROR
-    };
-
-    struct Literal
-    {
-        string param1;
-        LiteralType type;
-        Literal(string p1, LiteralType t) : param1(p1), type(t) {}
-    };
-
-    Directive searchLine(string line);
-    Instruction searchInstruction(string line);
-    Jump searchJump(string operand);
-    LoadStore searchLoadStore(string operand);
-    Literal searchLiteral(string literal);
-    bool isSymbol(string operand);
+public:
+    LineScanner::Directive searchLine(const string &line);
+    LineScanner::Instruction searchInstruction(const string &line);
+    LineScanner::Jump searchJump(const string &operand);
+    LineScanner::LoadStore searchLoadStore(const string &operand);
+    LineScanner::Literal searchLiteral(const string &literal);
+    bool isSymbol(const string &operand);
     string removeBlankLinesComments(string line);
     RegexWrapper();
     ~RegexWrapper();
@@ -0,0 +1,25 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Append only text storage: strings are copied into big blocks that are never moved,
+// so a stored view stays valid until the arena is deleted.
+class StringArena
+{
+private:
+    static const size_t BLOCK_SIZE = 64 * 1024;
+
+    vector<char *> blocks;
+    size_t used, capacity;
+
+public:
+    StringArena();
+    ~StringArena();
+    string_view store(string_view text);
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+using namespace std;
+
+// Fixed set of threads that run indexed tasks. forEach hands out the indices
+// 0..count-1 to the workers and the calling thread and returns when all are done.
+class WorkerPool
+{
+private:
+    vector<thread> workers;
+    mutex jobMutex;
+    condition_variable jobReady, jobDone;
+    const function<void(int)> *job;
+    int taskCount, activeWorkers;
+    atomic<int> nextTask;
+    unsigned long generation;
+    bool stopping;
+
+    void workerLoop();
+    void runTasks();
+
+public:
+    WorkerPool(int threadCount);
+    ~WorkerPool();
+    int getThreadCount();
+    void forEach(int count, const function<void(int)> &task);
+    static int getDefaultThreadCount();
+};
+
+#endif
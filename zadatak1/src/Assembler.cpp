@@ -0,0 +1,54 @@
+#include "../inc/Assembler.h"
+
+using namespace std;
+
+Assembler::Assembler() : onePass(false)
+{
+}
+
+Assembler::~Assembler()
+{
+}
+
+void Assembler::setOnePass(bool enabled)
+{
+    onePass = enabled;
+}
+
+AssemblerResult Assembler::assembleFile(const string &filePath)
+{
+    AssemblerResult result;
+    Parser *parser = new Parser();
+    parser->setFilesPath(filePath, "");
+    run(parser, result);
+    delete parser;
+    return result;
+}
+
+AssemblerResult Assembler::assembleSource(string_view source)
+{
+    AssemblerResult result;
+    Parser *parser = new Parser();
+    parser->setSource(source);
+    run(parser, result);
+    delete parser;
+    return result;
+}
+
+void Assembler::run(Parser *parser, AssemblerResult &result)
+{
+    parser->setOnePass(onePass);
+
+    Parser::Status status = parser->assemble();
+    result.success = status == Parser::SUCCESS;
+    result.inputError = status == Parser::INPUT_ERROR;
+
+    if (result.success)
+    {
+        parser->buildObjectFile(result.object);
+    }
+    else
+    {
+        parser->getDiagnostics(result.diagnostics);
+    }
+}
@@ -1,33 +1,139 @@
 #include <string>
+#include <cstring>
+#include <iterator>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "../inc/FileReader.h"
 
 using namespace std;
 
-FileReader::FileReader(string filePath)
+FileReader::FileReader(const string &filePath)
 {
-    file.open(filePath);
     endOfFile = false;
+    mapping = nullptr;
+    ownsMapping = true;
+    mappingSize = 0;
+    position = 0;
+
+    mapFile(filePath);
+    if (mapping == nullptr)
+    {
+        file.open(filePath);
+    }
+}
+
+FileReader::FileReader(const char *source, size_t size)
+{
+    // reads a buffer owned by the caller the same way as a mapped file
+    endOfFile = false;
+    mapping = source == nullptr ? "" : source;
+    ownsMapping = false;
+    mappingSize = size;
+    position = 0;
 }
 
 FileReader::~FileReader()
 {
+    if (mapping != nullptr && ownsMapping)
+    {
+        munmap((void *)mapping, mappingSize);
+    }
     file.close();
 }
 
+void FileReader::mapFile(const string &filePath)
+{
+    // stat before opening, so a fifo is never opened twice
+    struct stat info;
+    if (stat(filePath.c_str(), &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0)
+        return;
+
+    int descriptor = open(filePath.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return;
+
+    void *address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (address == MAP_FAILED)
+        return;
+
+    madvise(address, info.st_size, MADV_SEQUENTIAL);
+    mapping = (const char *)address;
+    mappingSize = info.st_size;
+}
+
 string FileReader::getNextLine()
 {
     string line;
-    endOfFile = !getline(file, line);
+    getNextLine(line);
     return line;
 }
 
+void FileReader::getNextLine(string &line)
+{
+    if (mapping == nullptr)
+    {
+        endOfFile = !getline(file, line);
+        return;
+    }
+
+    string_view view;
+    getNextLine(view);
+    line.assign(view.data(), view.size());
+}
+
+void FileReader::getNextLine(string_view &line)
+{
+    // a mapped line stays valid for the lifetime of the reader, a streamed one only until the next call
+    if (mapping == nullptr)
+    {
+        endOfFile = !getline(file, streamLine);
+        line = endOfFile ? string_view() : string_view(streamLine);
+        return;
+    }
+
+    if (position >= mappingSize)
+    {
+        endOfFile = true;
+        line = string_view();
+        return;
+    }
+
+    const char *start = mapping + position;
+    const char *newLine = (const char *)memchr(start, '\n', mappingSize - position);
+    size_t length = newLine == nullptr ? mappingSize - position : newLine - start;
+    line = string_view(start, length);
+    position += newLine == nullptr ? length : length + 1;
+}
+
 bool FileReader::isFileOpened()
 {
-    return file.is_open();
+    return mapping != nullptr || file.is_open();
 }
 
 bool FileReader::isEndOfFile()
 {
     return endOfFile;
 }
+
+bool FileReader::isMapped()
+{
+    return mapping != nullptr;
+}
+
+string_view FileReader::getContents()
+{
+    // a streamed input is read to the end once and then served like a mapped one
+    if (mapping == nullptr && file.is_open())
+    {
+        streamContents.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        file.close();
+        mapping = streamContents.data();
+        mappingSize = streamContents.size();
+        ownsMapping = false;
+    }
+    return mapping == nullptr ? string_view() : string_view(mapping, mappingSize);
+}
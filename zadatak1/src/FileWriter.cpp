@@ -2,82 +2,208 @@
 
 using namespace std;
 
-FileWriter::FileWriter(string filePath) : file(filePath)
+// two lowercase hex digits for every byte value
+struct HexTable
 {
+    char digits[512];
+    HexTable()
+    {
+        const char *hexDigits = "0123456789abcdef";
+        for (int i = 0; i < 256; i++)
+        {
+            digits[2 * i] = hexDigits[i >> 4];
+            digits[2 * i + 1] = hexDigits[i & 0xf];
+        }
+    }
+};
+
+static const HexTable hexTable;
+
+FileWriter::FileWriter(const string &filePath) : file(filePath, ios::binary), flushedBytes(0), hexMode(false)
+{
+    buffer.reserve(BUFFER_SIZE);
 }
 
 FileWriter::~FileWriter()
 {
+    flush();
     file.close();
 }
 
-void FileWriter::writeLine(string line)
+void FileWriter::append(string_view text)
+{
+    buffer.append(text.data(), text.size());
+}
+
+void FileWriter::appendHex(unsigned int value, int width)
+{
+    char digits[8];
+    int count = 0;
+    do
+    {
+        digits[7 - count++] = hexTable.digits[2 * (value & 0xf) + 1];
+        value >>= 4;
+    } while (value != 0);
+
+    if (width > count)
+    {
+        buffer.append(width - count, '0');
+    }
+    buffer.append(digits + 8 - count, count);
+}
+
+void FileWriter::appendNumber(int value)
+{
+    if (hexMode)
+    {
+        appendHex(value, 0);
+    }
+    else
+    {
+        append(to_string(value));
+    }
+}
+
+void FileWriter::flushIfFull()
 {
-    file << line << endl;
+    if (buffer.size() >= BUFFER_SIZE)
+    {
+        flush();
+    }
+}
+
+void FileWriter::flush()
+{
+    file.write(buffer.data(), buffer.size());
+    flushedBytes += buffer.size();
+    buffer.clear();
+}
+
+void FileWriter::writeLine(string_view line)
+{
+    append(line);
+    buffer += '\n';
+    flushIfFull();
 }
 
 void FileWriter::addNewLine()
 {
-    file << endl;
+    buffer += '\n';
 }
 
-void FileWriter::writeSection(int sectionId, string sectionName, int sectionSize)
+void FileWriter::writeSection(int sectionId, string_view sectionName, int sectionSize)
 {
-    file << sectionId << "\t" << sectionName << "\t" << hex << setfill('0') << setw(4) << (0xffff & sectionSize) << endl;
+    appendNumber(sectionId);
+    buffer += '\t';
+    append(sectionName);
+    buffer += '\t';
+    appendHex(0xffff & sectionSize, 4);
+    buffer += '\n';
+    hexMode = true;
+    flushIfFull();
 }
 
 void FileWriter::changeToDec()
 {
-    file << dec << endl;
+    hexMode = false;
+    buffer += '\n';
 }
-void FileWriter::writeSymbol(int offset, bool isLocal, bool isDefined, bool isExtern, string section, string name, int symbolId)
+
+void FileWriter::writeBytes(const void *data, size_t size)
 {
-    file << hex << setfill('0') << setw(4) << (0xffff & offset) << "\t";
+    if (buffer.size() + size > BUFFER_SIZE)
+    {
+        flush();
+        file.write((const char *)data, size);
+        flushedBytes += size;
+        return;
+    }
+    buffer.append((const char *)data, size);
+}
+
+void FileWriter::writeSymbol(int offset, bool isLocal, bool isDefined, bool isExtern, string_view section, string_view name, int symbolId)
+{
+    appendHex(0xffff & offset, 4);
     if (isLocal)
     {
-        file << "l\t";
+        append("\tl\t");
     }
     else if (isDefined)
     {
-        file << "g\t";
+        append("\tg\t");
     }
     else if (isExtern)
     {
-        file << "e\t";
+        append("\te\t");
     }
     else
     {
-        file << "u\t";
+        append("\tu\t");
     }
-    file << section << "\t" << name << "\t" << hex << setfill('0') << setw(4) << (0xffff & symbolId) << endl;
+    append(section);
+    buffer += '\t';
+    append(name);
+    buffer += '\t';
+    appendHex(0xffff & symbolId, 4);
+    buffer += '\n';
+    hexMode = true;
+    flushIfFull();
 }
 
-void FileWriter::writeRelocationValue(int offset, string type, bool isData, string symbolName, string sectionName)
+void FileWriter::writeRelocationValue(int offset, string_view type, bool isData, string_view symbolName, string_view sectionName)
 {
-    file << hex << setfill('0') << setw(4) << (0xffff & offset) << "\t" << type << "\t" << (isData ? 'd' : 'i') << "\t" << symbolName << "\t" << sectionName << endl;
+    appendHex(0xffff & offset, 4);
+    buffer += '\t';
+    append(type);
+    append(isData ? "\td\t" : "\ti\t");
+    append(symbolName);
+    buffer += '\t';
+    append(sectionName);
+    buffer += '\n';
+    hexMode = true;
+    flushIfFull();
 }
 
-void FileWriter::writeSectionData(vector<int> offsets, vector<char> data)
+void FileWriter::writeSectionData(const vector<int> &offsets, const vector<char> &data, const vector<ObjectZeroFill> &zeroFills)
 {
-    for (int i = 0; i < offsets.size() - 1; i++)
+    // one row per emitted item: "offset: b0 b1 ... ", a zero fill is "offset: .skip size";
+    // the last row is not terminated
+    hexMode = true;
+    size_t position = 0, fill = 0;
+    for (size_t i = 0; i < offsets.size(); i++)
     {
         int currentOffset = offsets[i];
-        int nextOffset = offsets[i + 1];
-        file << hex << setfill('0') << setw(4) << (0xffff & currentOffset) << ": ";
-        for (int j = currentOffset; j < nextOffset; j++)
+        appendHex(0xffff & currentOffset, 4);
+        append(": ");
+        if (fill < zeroFills.size() && (int)zeroFills[fill].offset == currentOffset)
+        {
+            append(".skip ");
+            appendHex(0xffff & zeroFills[fill++].size, 4);
+        }
+        else
         {
-            char c = data[j];
-            file << hex << setfill('0') << setw(2) << (0xff & c) << " ";
+            size_t end = i + 1 < offsets.size() ? position + offsets[i + 1] - currentOffset : data.size();
+            for (; position < end; position++)
+            {
+                const char *digits = hexTable.digits + 2 * (unsigned char)data[position];
+                char byte[3] = {digits[0], digits[1], ' '};
+                buffer.append(byte, 3);
+            }
         }
-        file << endl;
+        if (i + 1 < offsets.size())
+        {
+            buffer += '\n';
+        }
+        flushIfFull();
     }
+}
 
-    int currentOffset = offsets[offsets.size() - 1];
-    int nextOffset = data.size();
-    file << hex << setfill('0') << setw(4) << (0xffff & currentOffset) << ": ";
-    for (int j = currentOffset; j < nextOffset; j++)
-    {
-        char c = data[j];
-        file << hex << setfill('0') << setw(2) << (0xff & c) << " ";
-    }
+bool FileWriter::isFileOpened()
+{
+    return file.is_open();
+}
+
+size_t FileWriter::getBytesWritten()
+{
+    return flushedBytes + buffer.size();
 }
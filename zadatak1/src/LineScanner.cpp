@@ -0,0 +1,531 @@
+#include "../inc/LineScanner.h"
+
+using namespace std;
+
+// Hand-written replacement for the regex cascade in RegexWrapper. Every search
+// scans the line once and returns exactly what the matching regex would have
+// captured, so the results can be compared one to one (see tests/LineScannerTest.cpp).
+
+LineScanner::LineScanner() : callCount(0)
+{
+}
+
+LineScanner::~LineScanner()
+{
+}
+
+bool LineScanner::isLetter(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+bool LineScanner::isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+bool LineScanner::startsWith(string_view text, string_view prefix)
+{
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool LineScanner::hasLineBreak(string_view text)
+{
+    // '.' in the regex grammar does not match line terminators
+    return text.find_first_of("\r\n") != string_view::npos;
+}
+
+size_t LineScanner::symbolLength(string_view text)
+{
+    if (text.empty() || !isLetter(text[0]))
+    {
+        return 0;
+    }
+
+    size_t length = 1;
+    while (length < text.size() && (isLetter(text[length]) || isDigit(text[length]) || text[length] == '_'))
+    {
+        length++;
+    }
+    return length;
+}
+
+bool LineScanner::isDecimal(string_view text)
+{
+    size_t start = !text.empty() && text[0] == '-' ? 1 : 0;
+    if (start == text.size())
+    {
+        return false;
+    }
+
+    for (size_t i = start; i < text.size(); i++)
+    {
+        if (!isDigit(text[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LineScanner::isHexaDecimal(string_view text)
+{
+    if (text.size() < 3 || !startsWith(text, "0x"))
+    {
+        return false;
+    }
+
+    for (size_t i = 2; i < text.size(); i++)
+    {
+        if (!isDigit(text[i]) && !(text[i] >= 'A' && text[i] <= 'F'))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LineScanner::isSymbolOrLiteral(string_view text)
+{
+    return (!text.empty() && symbolLength(text) == text.size()) || isDecimal(text) || isHexaDecimal(text);
+}
+
+size_t LineScanner::registerLength(string_view text)
+{
+    if (text.size() >= 2 && text[0] == 'r' && text[1] >= '0' && text[1] <= '7')
+    {
+        return 2;
+    }
+    if (startsWith(text, "psw"))
+    {
+        return 3;
+    }
+    return 0;
+}
+
+bool LineScanner::isRegister(string_view text)
+{
+    return !text.empty() && registerLength(text) == text.size();
+}
+
+bool LineScanner::isSymbolList(string_view text, string_view &lastItem)
+{
+    // symbol(,symbol)* - lastItem is what the repeated group captured last
+    lastItem = string_view();
+    bool first = true;
+    while (true)
+    {
+        size_t comma = text.find(',');
+        string_view item = text.substr(0, comma);
+        if (item.empty() || symbolLength(item) != item.size())
+        {
+            return false;
+        }
+        if (!first)
+        {
+            lastItem = string_view(item.data() - 1, item.size() + 1);
+        }
+        if (comma == string_view::npos)
+        {
+            return true;
+        }
+        text.remove_prefix(comma + 1);
+        first = false;
+    }
+}
+
+bool LineScanner::isOperandList(string_view text, string_view &firstItem)
+{
+    firstItem = text.substr(0, text.find(','));
+    while (true)
+    {
+        size_t comma = text.find(',');
+        if (!isSymbolOrLiteral(text.substr(0, comma)))
+        {
+            return false;
+        }
+        if (comma == string_view::npos)
+        {
+            return true;
+        }
+        text.remove_prefix(comma + 1);
+    }
+}
+
+bool LineScanner::splitIndirect(string_view text, string_view &reg, string_view &displacement, bool &hasDisplacement)
+{
+    // [reg] or [reg + symbolOrLiteral]
+    if (text.size() < 3 || text.front() != '[' || text.back() != ']')
+    {
+        return false;
+    }
+
+    string_view inner = text.substr(1, text.size() - 2);
+    size_t length = registerLength(inner);
+    if (length == 0)
+    {
+        return false;
+    }
+
+    reg = inner.substr(0, length);
+    if (length == inner.size())
+    {
+        hasDisplacement = false;
+        return true;
+    }
+
+    if (!startsWith(inner.substr(length), " + "))
+    {
+        return false;
+    }
+
+    displacement = inner.substr(length + 3);
+    hasDisplacement = true;
+    return isSymbolOrLiteral(displacement);
+}
+
+LineScanner::Directive LineScanner::searchLine(string_view text)
+{
+    callCount++;
+    size_t length = symbolLength(text);
+    if (length > 0 && length < text.size() && text[length] == ':')
+    {
+        string_view name = text.substr(0, length);
+        string_view rest = text.substr(length + 1);
+        if (rest.empty())
+        {
+            return Directive(name, "", LABEL);
+        }
+        if (!hasLineBreak(rest))
+        {
+            return Directive(name, rest, LABEL_WITH_INSTRUCTION);
+        }
+        return Directive("", "", INSTRUCTION);
+    }
+
+    if (text.empty() || text[0] != '.')
+    {
+        return Directive("", "", INSTRUCTION);
+    }
+
+    if (startsWith(text, ".section "))
+    {
+        string_view name = text.substr(9);
+        if (!name.empty() && symbolLength(name) == name.size())
+        {
+            return Directive(name, "", SECTION);
+        }
+    }
+    else if (startsWith(text, ".equ "))
+    {
+        string_view arguments = text.substr(5);
+        size_t comma = arguments.find(',');
+        if (comma != string_view::npos)
+        {
+            string_view name = arguments.substr(0, comma);
+            string_view value = arguments.substr(comma + 1);
+            if (!name.empty() && symbolLength(name) == name.size() && (isDecimal(value) || isHexaDecimal(value)))
+            {
+                return Directive(name, value, EQU);
+            }
+        }
+    }
+    else if (startsWith(text, ".skip "))
+    {
+        string_view value = text.substr(6);
+        if (isDecimal(value) || isHexaDecimal(value))
+        {
+            return Directive(value, "", SKIP);
+        }
+    }
+    else if (text == ".end")
+    {
+        return Directive("", "", END);
+    }
+    else if (startsWith(text, ".global ") || startsWith(text, ".extern "))
+    {
+        string_view symbols = text.substr(8);
+        string_view lastItem;
+        if (isSymbolList(symbols, lastItem))
+        {
+            return Directive(symbols, lastItem, text[1] == 'g' ? GLOBAL : EXTERNAL);
+        }
+    }
+    else if (startsWith(text, ".word "))
+    {
+        string_view operands = text.substr(6);
+        string_view firstItem;
+        if (isOperandList(operands, firstItem))
+        {
+            return Directive(operands, firstItem, WORD);
+        }
+    }
+
+    return Directive("", "", INSTRUCTION);
+}
+
+LineScanner::Instruction LineScanner::searchInstruction(string_view text)
+{
+    callCount++;
+    size_t space = text.find(' ');
+    string_view operation = text.substr(0, space);
+    const InstructionInfo *info = findInstruction(operation);
+    if (info == nullptr)
+    {
+        return Instruction("", "", "", BAD_INSTRUCTION);
+    }
+
+    if (space == string_view::npos)
+    {
+        if (info->shape == NO_OPERAND_SHAPE)
+        {
+            return Instruction(text, "", "", NO_OPERAND, info);
+        }
+        return Instruction("", "", "", BAD_INSTRUCTION);
+    }
+
+    string_view operands = text.substr(space + 1);
+    size_t length;
+    switch (info->shape)
+    {
+    case REGISTER_SHAPE:
+        if (isRegister(operands))
+        {
+            return Instruction(operation, operands, "", ONE_OPERAND, info);
+        }
+        break;
+    case JUMP_SHAPE:
+        if (!hasLineBreak(operands))
+        {
+            return Instruction(operation, operands, "", ONE_OPERAND_JUMP, info);
+        }
+        break;
+    case LOAD_STORE_SHAPE:
+        length = registerLength(operands);
+        if (length > 0 && length < operands.size() && operands[length] == ',' && !hasLineBreak(operands.substr(length + 1)))
+        {
+            return Instruction(operation, operands.substr(0, length), operands.substr(length + 1), TWO_OPERAND_LOAD_STORE, info);
+        }
+        break;
+    case TWO_REGISTER_SHAPE:
+        length = registerLength(operands);
+        if (length > 0 && length < operands.size() && operands[length] == ',' && isRegister(operands.substr(length + 1)))
+        {
+            return Instruction(operation, operands.substr(0, length), operands.substr(length + 1), TWO_OPERAND, info);
+        }
+        break;
+    default:
+        break;
+    }
+
+    return Instruction("", "", "", BAD_INSTRUCTION);
+}
+
+LineScanner::Jump LineScanner::searchJump(string_view text)
+{
+    callCount++;
+    if (isSymbolOrLiteral(text))
+    {
+        return Jump(text, "", JUMP_ABS);
+    }
+
+    if (!text.empty() && text[0] == '%')
+    {
+        string_view symbol = text.substr(1);
+        if (!symbol.empty() && symbolLength(symbol) == symbol.size())
+        {
+            return Jump(symbol, "", JUMP_PC_RELATIVE);
+        }
+    }
+    else if (!text.empty() && text[0] == '*')
+    {
+        string_view address = text.substr(1);
+        string_view reg, displacement;
+        bool hasDisplacement;
+
+        if (isRegister(address))
+        {
+            return Jump(address, "", JUMP_REG_DIR);
+        }
+        if (splitIndirect(address, reg, displacement, hasDisplacement))
+        {
+            if (hasDisplacement)
+            {
+                return Jump(reg, displacement, JUMP_REG_IND_DISPL);
+            }
+            return Jump(reg, "", JUMP_REG_IND);
+        }
+        if (isSymbolOrLiteral(address))
+        {
+            return Jump(address, "", JUMP_MEM_DIR);
+        }
+    }
+
+    return Jump("", "", BAD_JUMP);
+}
+
+LineScanner::LoadStore LineScanner::searchLoadStore(string_view text)
+{
+    callCount++;
+    string_view reg, displacement;
+    bool hasDisplacement;
+
+    if (!text.empty() && text[0] == '$')
+    {
+        string_view value = text.substr(1);
+        if (isSymbolOrLiteral(value))
+        {
+            return LoadStore(value, "", symbolLength(value) > 0 ? LOAD_STORE_ABS_SYMBOL : LOAD_STORE_ABS_VALUE);
+        }
+    }
+    else if (!text.empty() && text[0] == '%')
+    {
+        string_view symbol = text.substr(1);
+        if (!symbol.empty() && symbolLength(symbol) == symbol.size())
+        {
+            return LoadStore(symbol, "", LOAD_STORE_PC_RELATIVE);
+        }
+    }
+    else if (isRegister(text))
+    {
+        return LoadStore(text, "", LOAD_STORE_REG_DIR);
+    }
+    else if (splitIndirect(text, reg, displacement, hasDisplacement))
+    {
+        if (!hasDisplacement)
+        {
+            return LoadStore(reg, "", LOAD_STORE_REG_IND);
+        }
+        return LoadStore(reg, displacement, symbolLength(displacement) > 0 ? LOAD_STORE_REG_IND_DISPL_SYMBOL : LOAD_STORE_REG_IND_DISPL_VALUE);
+    }
+    else if (isSymbolOrLiteral(text))
+    {
+        return LoadStore(text, "", symbolLength(text) > 0 ? LOAD_STORE_MEM_DIR_SYMBOL : LOAD_STORE_MEM_DIR_VALUE);
+    }
+
+    return LoadStore("", "", BAD_LOAD_STORE);
+}
+
+LineScanner::Literal LineScanner::searchLiteral(string_view literal)
+{
+    callCount++;
+    if (isHexaDecimal(literal))
+    {
+        return Literal(literal, HEXA_DECIMAL);
+    }
+    else if (isDecimal(literal))
+    {
+        return Literal(literal, DECIMAL);
+    }
+    else
+    {
+        return Literal("", ERROR);
+    }
+}
+
+bool LineScanner::isSymbol(string_view operand)
+{
+    callCount++;
+    return !operand.empty() && symbolLength(operand) == operand.size();
+}
+
+void LineScanner::normalizeLine(string &line)
+{
+    // Strips the comment, collapses whitespace and removes the spaces around ',' and ':'
+    // in one pass over the line, writing the result back into the same buffer. The
+    // result is the same as the six regex_replace calls in RegexWrapper, quirks included:
+    // tabs are turned into spaces after runs of spaces are collapsed, a comment ends at
+    // a line break and the boundary spaces stay if the line has a single visible character.
+    size_t length = line.size();
+    size_t comment = line.find('#');
+    size_t resume = comment == string::npos ? length : line.find_first_of("\r\n", comment);
+    resume = resume == string::npos ? length : resume;
+
+    size_t out = 0;
+    bool previousSpace = false, skipSpace = false;
+    size_t visible = 0, lineBreaks = 0;
+    bool firstIsLineBreak = false, lastIsLineBreak = false;
+
+    for (size_t in = 0; in < length; in++)
+    {
+        if (in == comment)
+        {
+            in = resume;
+            if (in == length)
+                break;
+        }
+
+        char c = line[in];
+        if (c == ' ' && previousSpace)
+            continue;
+        previousSpace = c == ' ';
+
+        if (c == ' ' || c == '\t')
+        {
+            if (skipSpace)
+                skipSpace = false;
+            else
+                line[out++] = ' ';
+            continue;
+        }
+
+        bool lineBreak = c == '\r' || c == '\n';
+        firstIsLineBreak = visible == 0 ? lineBreak : firstIsLineBreak;
+        lastIsLineBreak = lineBreak;
+        lineBreaks += lineBreak;
+        visible++;
+
+        skipSpace = c == ',' || c == ':';
+        if (skipSpace && out > 0 && line[out - 1] == ' ')
+            out--;
+        line[out++] = c;
+    }
+    line.resize(out);
+
+    // boundary spaces are trimmed only around two or more visible characters with no line break between them
+    if (visible < 2 || lineBreaks > (size_t)firstIsLineBreak + (size_t)lastIsLineBreak)
+        return;
+
+    size_t first = line.find_first_not_of(' ');
+    line.resize(line.find_last_not_of(' ') + 1);
+    line.erase(0, first);
+}
+
+bool LineScanner::isTrimOnly(string_view line, size_t &first, size_t &last)
+{
+    first = line.find_first_not_of(' ');
+    last = line.find_last_not_of(' ');
+    if (first == string_view::npos || first == last)
+        return false;
+
+    for (size_t i = first; i <= last; i++)
+    {
+        char c = line[i];
+        if (c == '#' || c == '\t' || c == '\r' || c == '\n')
+            return false;
+        if (c == ' ' && (line[i + 1] == ' ' || line[i + 1] == ',' || line[i + 1] == ':'))
+            return false;
+        if ((c == ',' || c == ':') && line[i + 1] == ' ' && i < last)
+            return false;
+    }
+    return true;
+}
+
+string_view LineScanner::normalizeLine(string_view line, string &buffer)
+{
+    // Most lines only lose their indentation, those are returned as a view into the
+    // original line. The rest is normalized in buffer, which the caller owns and reuses.
+    callCount++;
+    size_t first, last;
+    if (isTrimOnly(line, first, last))
+        return line.substr(first, last - first + 1);
+
+    buffer.assign(line.data(), line.size());
+    normalizeLine(buffer);
+    return buffer;
+}
+
+unsigned long LineScanner::getCallCount()
+{
+    return callCount;
+}
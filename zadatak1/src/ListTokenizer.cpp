@@ -0,0 +1,22 @@
+#include "../inc/ListTokenizer.h"
+
+using namespace std;
+
+ListTokenizer::ListTokenizer(string_view text) : list(text), position(0)
+{
+}
+
+bool ListTokenizer::next(string_view &item)
+{
+    // a trailing comma does not end with an empty item
+    if (position >= list.size())
+    {
+        return false;
+    }
+
+    size_t comma = list.find(',', position);
+    size_t end = comma == string_view::npos ? list.size() : comma;
+    item = list.substr(position, end - position);
+    position = end + 1;
+    return true;
+}
@@ -0,0 +1,59 @@
+#include "../inc/NamePool.h"
+
+using namespace std;
+
+NamePool::NamePool()
+{
+    arena = new StringArena();
+    intern("");
+}
+
+NamePool::~NamePool()
+{
+    delete arena;
+}
+
+int NamePool::intern(string_view name)
+{
+    unordered_map<string_view, int>::iterator it = index.find(name);
+    if (it != index.end())
+    {
+        return it->second;
+    }
+
+    // the key is the stored copy, so the caller's text can go away
+    string_view stored = arena->store(name);
+    names.push_back(stored);
+    index.emplace(stored, names.size() - 1);
+    return names.size() - 1;
+}
+
+int NamePool::find(string_view name)
+{
+    unordered_map<string_view, int>::iterator it = index.find(name);
+    return it == index.end() ? NOT_FOUND : it->second;
+}
+
+string_view NamePool::getName(int handle)
+{
+    return handle >= 0 && handle < (int)names.size() ? names[handle] : string_view();
+}
+
+int NamePool::countProbes(string_view name)
+{
+    // a probe is one key comparison: the entries before the match, or the whole bucket on a miss
+    int probes = 0;
+    size_t bucket = index.bucket(name);
+    for (unordered_map<string_view, int>::local_iterator it = index.begin(bucket); it != index.end(bucket); it++)
+    {
+        probes++;
+        if (it->first == name)
+            break;
+    }
+    return probes;
+}
+
+int NamePool::size()
+{
+    return names.size();
+}
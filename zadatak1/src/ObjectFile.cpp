@@ -0,0 +1,193 @@
+#include <cstring>
+
+#include "../inc/ObjectFile.h"
+#include "../inc/FileWriter.h"
+#include "../inc/FileReader.h"
+
+using namespace std;
+
+ObjectFile::ObjectFile()
+{
+}
+
+ObjectFile::~ObjectFile()
+{
+}
+
+uint32_t ObjectFile::addString(string_view name)
+{
+    uint32_t offset = stringTable.size();
+    stringTable.append(name.data(), name.size());
+    stringTable += '\0';
+    return offset;
+}
+
+string_view ObjectFile::getString(uint32_t offset) const
+{
+    if (offset >= stringTable.size())
+    {
+        return string_view();
+    }
+    return string_view(stringTable.c_str() + offset);
+}
+
+void ObjectFile::getSectionBytes(const ObjectSection &section, vector<char> &bytes) const
+{
+    // flat image of the section: stored bytes with every zero fill span written out
+    bytes.clear();
+    bytes.reserve(section.size);
+    const char *stored = data.data() + section.dataOffset;
+    uint32_t copied = 0;
+    for (uint32_t i = section.firstZeroFill; i < section.firstZeroFill + section.zeroFillCount; i++)
+    {
+        bytes.insert(bytes.end(), stored + copied, stored + zeroFills[i].dataOffset);
+        bytes.insert(bytes.end(), zeroFills[i].size, 0);
+        copied = zeroFills[i].dataOffset;
+    }
+    bytes.insert(bytes.end(), stored + copied, stored + section.dataSize);
+}
+
+void ObjectFile::serialize(string &bytes) const
+{
+    // keep the section data 4 byte aligned behind the string table
+    uint32_t stringTableSize = (stringTable.size() + 3) & ~3u;
+
+    ObjectHeader header = {};
+    header.magic = OBJECT_MAGIC;
+    header.version = OBJECT_VERSION;
+    header.sectionCount = sections.size();
+    header.sectionTableOffset = sizeof(ObjectHeader);
+    header.symbolCount = symbols.size();
+    header.symbolTableOffset = header.sectionTableOffset + sections.size() * sizeof(ObjectSection);
+    header.relocationCount = relocations.size();
+    header.relocationTableOffset = header.symbolTableOffset + symbols.size() * sizeof(ObjectSymbol);
+    header.zeroFillCount = zeroFills.size();
+    header.zeroFillTableOffset = header.relocationTableOffset + relocations.size() * sizeof(ObjectRelocation);
+    header.stringTableSize = stringTableSize;
+    header.stringTableOffset = header.zeroFillTableOffset + zeroFills.size() * sizeof(ObjectZeroFill);
+    header.dataSize = data.size();
+    header.dataOffset = header.stringTableOffset + stringTableSize;
+
+    bytes.clear();
+    bytes.reserve(header.dataOffset + data.size());
+    bytes.append((const char *)&header, sizeof(header));
+    for (vector<ObjectSection>::const_iterator section = sections.begin(); section != sections.end(); section++)
+    {
+        ObjectSection entry = *section;
+        entry.dataOffset += header.dataOffset;
+        bytes.append((const char *)&entry, sizeof(entry));
+    }
+    bytes.append((const char *)symbols.data(), symbols.size() * sizeof(ObjectSymbol));
+    bytes.append((const char *)relocations.data(), relocations.size() * sizeof(ObjectRelocation));
+    bytes.append((const char *)zeroFills.data(), zeroFills.size() * sizeof(ObjectZeroFill));
+    bytes.append(stringTable);
+    bytes.append(stringTableSize - stringTable.size(), '\0');
+    bytes.append(data.data(), data.size());
+}
+
+bool ObjectFile::write(const string &filePath) const
+{
+    string bytes;
+    serialize(bytes);
+
+    FileWriter *fw = new FileWriter(filePath);
+    bool opened = fw->isFileOpened();
+    fw->writeBytes(bytes.data(), bytes.size());
+    delete fw;
+    return opened;
+}
+
+template <typename T>
+static bool readTable(string_view bytes, uint32_t offset, uint32_t count, vector<T> &table)
+{
+    if (offset > bytes.size() || count > (bytes.size() - offset) / sizeof(T))
+    {
+        return false;
+    }
+    table.resize(count);
+    memcpy(table.data(), bytes.data() + offset, count * sizeof(T));
+    return true;
+}
+
+bool ObjectFile::parse(string_view bytes)
+{
+    // every count and index is checked here, so users of the tables can trust them
+    ObjectHeader header;
+    if (bytes.size() < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != OBJECT_MAGIC || header.version != OBJECT_VERSION)
+    {
+        return false;
+    }
+
+    if (!readTable(bytes, header.sectionTableOffset, header.sectionCount, sections) ||
+        !readTable(bytes, header.symbolTableOffset, header.symbolCount, symbols) ||
+        !readTable(bytes, header.relocationTableOffset, header.relocationCount, relocations) ||
+        !readTable(bytes, header.zeroFillTableOffset, header.zeroFillCount, zeroFills))
+    {
+        return false;
+    }
+    if (header.stringTableOffset > bytes.size() || header.stringTableSize > bytes.size() - header.stringTableOffset ||
+        header.dataOffset > bytes.size() || header.dataSize > bytes.size() - header.dataOffset)
+    {
+        return false;
+    }
+    stringTable.assign(bytes.data() + header.stringTableOffset, header.stringTableSize);
+    stringTable += '\0';
+    data.assign(bytes.data() + header.dataOffset, bytes.data() + header.dataOffset + header.dataSize);
+
+    for (vector<ObjectSection>::iterator section = sections.begin(); section != sections.end(); section++)
+    {
+        if (section->dataOffset < header.dataOffset)
+        {
+            return false;
+        }
+        section->dataOffset -= header.dataOffset;
+        if (section->dataSize > data.size() || section->dataOffset > data.size() - section->dataSize ||
+            section->relocationCount > relocations.size() || section->firstRelocation > relocations.size() - section->relocationCount ||
+            section->zeroFillCount > zeroFills.size() || section->firstZeroFill > zeroFills.size() - section->zeroFillCount)
+        {
+            return false;
+        }
+
+        // getSectionBytes copies the stored bytes between fills, so the fills have to be in order and inside the section
+        uint32_t previousOffset = 0, previousDataOffset = 0;
+        for (uint32_t i = section->firstZeroFill; i < section->firstZeroFill + section->zeroFillCount; i++)
+        {
+            const ObjectZeroFill &fill = zeroFills[i];
+            if (fill.dataOffset > section->dataSize || fill.dataOffset < previousDataOffset || fill.offset < previousOffset ||
+                (uint64_t)fill.offset + fill.size > section->size)
+            {
+                return false;
+            }
+            previousOffset = fill.offset;
+            previousDataOffset = fill.dataOffset;
+        }
+    }
+    for (vector<ObjectSymbol>::iterator symbol = symbols.begin(); symbol != symbols.end(); symbol++)
+    {
+        if (symbol->section < 0 || symbol->section >= (int32_t)sections.size())
+        {
+            return false;
+        }
+    }
+    for (vector<ObjectRelocation>::iterator relocation = relocations.begin(); relocation != relocations.end(); relocation++)
+    {
+        if (relocation->symbol != OBJECT_NO_SYMBOL && (relocation->symbol < 0 || relocation->symbol >= (int32_t)symbols.size()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ObjectFile::read(const string &filePath)
+{
+    FileReader *fr = new FileReader(filePath);
+    bool parsed = fr->isFileOpened() && parse(fr->getContents());
+    delete fr;
+    return parsed;
+}
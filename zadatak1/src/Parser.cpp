@@ -2,1107 +2,1144 @@
 #include <fstream>
 #include <vector>
 #include <iomanip>
+#include <algorithm>
 
 #include "../inc/Parser.h"
 #include "../inc/FileReader.h"
 #include "../inc/FileWriter.h"
+#include "../inc/ListTokenizer.h"
 
 using namespace std;
 
-Parser *Parser::instance = 0;
-int Parser::symbolId = 0;
-int Parser::sectionId = 0;
-
-Parser *Parser::getInstance()
+static double millisecondsSince(chrono::steady_clock::time_point start)
 {
-    if (!instance)
-    {
-        instance = new Parser();
-    }
-    return instance;
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
 }
 
-Parser::Parser() : inputFilePath(""), outputFilePath(""), currentSection(""), locationCounter(0)
+Parser::Parser() : symbolId(0), sectionId(0), inputFilePath(""), outputFilePath(""), hasInputSource(false), currentSection(NamePool::EMPTY), activeSection(-1), locationCounter(0), onePass(false), outputFormat(TEXT), collectStatistics(false), inputFile(nullptr), workerPool(nullptr), parallelScannerCalls(0), symbolLookups(0), symbolProbes(0)
 {
-    addSection(0, UNDEFINED);
-    addSymbol(0, true, true, false, UNDEFINED, UNDEFINED);
+    names = new NamePool();
+    undefinedName = names->intern(UNDEFINED);
+    absoluteName = names->intern(ABSOLUTE);
 
-    addSection(0, ABSOLUTE);
-    addSymbol(0, true, true, false, ABSOLUTE, ABSOLUTE);
+    addSymbol(0, true, true, false, undefinedName, undefinedName);
+    addSection(0, undefinedName);
 
-    regexWrapper = new RegexWrapper();
+    addSymbol(0, true, true, false, absoluteName, absoluteName);
+    addSection(0, absoluteName);
+
+    lineScanner = new LineScanner();
+    lineNumberBeforeProcessing.push_back(0);
 }
 
 Parser::~Parser()
 {
-    delete regexWrapper;
+    for (vector<StringArena *>::iterator arena = chunkArenas.begin(); arena != chunkArenas.end(); arena++)
+    {
+        delete *arena;
+    }
+    delete inputFile;
+    delete names;
+    delete lineScanner;
 }
 
-void Parser::setFilesPath(string iFile, string oFile)
+void Parser::setFilesPath(const string &iFile, const string &oFile)
 {
     inputFilePath = iFile;
     outputFilePath = oFile;
 }
 
-void Parser::compile()
+void Parser::setSource(string_view source)
 {
-    if (inputFilePath == "" || outputFilePath == "")
+    // the source is read in place, it has to outlive assemble
+    inputSource = source;
+    hasInputSource = true;
+}
+
+void Parser::setWorkerPool(WorkerPool *pool)
+{
+    // cleanup and line classification are split over the pool, without one they run here
+    workerPool = pool;
+}
+
+void Parser::runTasks(int count, const function<void(int)> &task)
+{
+    if (workerPool)
     {
-        cout << "Set path to files first!" << endl;
+        workerPool->forEach(count, task);
         return;
     }
+    for (int i = 0; i < count; i++)
+    {
+        task(i);
+    }
+}
 
-    if (!removeBlankLinesComments())
+void Parser::setOnePass(bool enabled)
+{
+    onePass = enabled;
+}
+
+void Parser::setOutputFormat(OutputFormat format)
+{
+    outputFormat = format;
+}
+
+bool Parser::compile(ostream &messages)
+{
+    if (inputFilePath == "" || outputFilePath == "")
     {
-        cout << "Code cleanup error" << endl;
-        return;
+        messages << "Set path to files first!" << endl;
+        return false;
     }
 
-    if (!firstPass())
+    Status status = assemble();
+    if (status == INPUT_ERROR)
     {
-        printErrors();
-        return;
+        messages << "Cannot open the file with path: " + inputFilePath << endl;
+        messages << "Code cleanup error" << endl;
+        return false;
+    }
+    if (status == ASSEMBLY_ERROR)
+    {
+        printErrors(messages);
+        return false;
     }
 
-    if (!secondPass())
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bool written = outputFormat == BINARY ? createBinaryFile() : createTxtFile();
+    statistics.outputTime = millisecondsSince(start);
+    if (!written)
     {
-        printErrors();
-        return;
+        messages << "Cannot open the output file with path: " + outputFilePath << endl;
+    }
+    return written;
+}
+
+Parser::Status Parser::assemble()
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    if (onePass)
+    {
+        Status status = assembleInOnePass();
+        statistics.firstPassTime = millisecondsSince(start);
+        statistics.scannerCalls = lineScanner->getCallCount() + parallelScannerCalls;
+        return status;
+    }
+
+    bool cleaned = removeBlankLinesComments();
+    statistics.cleanupTime = millisecondsSince(start);
+    if (!cleaned)
+    {
+        return INPUT_ERROR;
     }
 
-    createTxtFile();
+    start = chrono::steady_clock::now();
+    bool passed = firstPass();
+    statistics.firstPassTime = millisecondsSince(start);
+    if (!passed)
+    {
+        return ASSEMBLY_ERROR;
+    }
+
+    start = chrono::steady_clock::now();
+    passed = secondPass();
+    statistics.secondPassTime = millisecondsSince(start);
+    statistics.scannerCalls = lineScanner->getCallCount() + parallelScannerCalls;
+    return passed ? SUCCESS : ASSEMBLY_ERROR;
 }
 
-bool Parser::removeBlankLinesComments()
+FileReader *Parser::openInput()
+{
+    if (hasInputSource)
+    {
+        return new FileReader(inputSource.data(), inputSource.size());
+    }
+    return new FileReader(inputFilePath);
+}
+
+Parser::Status Parser::assembleInOnePass()
 {
-    FileReader *fr = new FileReader(inputFilePath);
+    // cleans, decodes and encodes one line at a time; symbol operands are
+    // written as zeros and patched from the fixup list when the input ends
+    FileReader *fr = openInput();
     if (!fr->isFileOpened())
     {
-        cout << "Cannot open the file with path: " + inputFilePath << endl;
-        return false;
+        delete fr;
+        return INPUT_ERROR;
     }
 
-    string line = fr->getNextLine();
+    // the line is consumed before the next one is read, so a streamed view is fine here
+    string_view rawLine;
+    string buffer;
+    fr->getNextLine(rawLine);
     int lineBeforeProcessing = 0;
-    int lineAfterProcessing = 0;
-    while (!fr->isEndOfFile())
+    currentLine = 0;
+    reachedEnd = false;
+    bool hasError = false;
+    SectionEncoder encoder(NamePool::EMPTY);
+    while (!fr->isEndOfFile() && !reachedEnd)
     {
         lineBeforeProcessing++;
-        line = regexWrapper->removeBlankLinesComments(line);
+        string_view line = lineScanner->normalizeLine(rawLine, buffer);
 
         if (line.empty() || line == " ")
         {
-            line = fr->getNextLine();
+            fr->getNextLine(rawLine);
             continue;
         }
 
-        lineAfterProcessing++;
-        lineNumberBeforeProcessing[lineAfterProcessing] = lineBeforeProcessing;
-        inputFileWithClearedLines.push_back(line);
-        line = fr->getNextLine();
-    }
+        currentLine++;
+        lineNumberBeforeProcessing.push_back(lineBeforeProcessing);
+        statistics.linesBeforeCleanup = lineBeforeProcessing;
+        statistics.linesAfterCleanup = currentLine;
+        decodeLine(line, hasError);
 
+        for (vector<DecodedLine>::iterator decoded = decodedLines.begin(); decoded != decodedLines.end(); decoded++)
+        {
+            encodeLine(*decoded, encoder);
+            commitEncoder(encoder);
+        }
+        decodedLines.clear();
+        wordOperands.clear();
+
+        fr->getNextLine(rawLine);
+    }
     delete fr;
+
+    if (hasError || !resolveFixups())
+    {
+        return ASSEMBLY_ERROR;
+    }
+    return SUCCESS;
+}
+
+bool Parser::removeBlankLinesComments()
+{
+    // the reader stays open until the parser is deleted, unchanged lines are kept as views into it
+    inputFile = openInput();
+    if (!inputFile->isFileOpened())
+    {
+        return false;
+    }
+
+    // chunks start right after a line break, so every line is cleaned by exactly one task
+    const size_t CHUNK_SIZE = 256 * 1024;
+    string_view contents = inputFile->getContents();
+    vector<CleanupChunk> chunks;
+    size_t start = 0;
+    while (start < contents.size())
+    {
+        size_t end = start + CHUNK_SIZE < contents.size() ? contents.find('\n', start + CHUNK_SIZE) : string_view::npos;
+        end = end == string_view::npos ? contents.size() : end + 1;
+        chunks.push_back(CleanupChunk(contents.substr(start, end - start)));
+        start = end;
+    }
+
+    for (vector<CleanupChunk>::iterator chunk = chunks.begin(); chunk != chunks.end(); chunk++)
+    {
+        chunk->arena = new StringArena();
+        chunkArenas.push_back(chunk->arena);
+    }
+    runTasks(chunks.size(), [this, &chunks](int i)
+    {
+        cleanupChunk(chunks[i]);
+    });
+
+    // line numbers are made global in chunk order
+    int lineBeforeProcessing = 0;
+    for (vector<CleanupChunk>::iterator chunk = chunks.begin(); chunk != chunks.end(); chunk++)
+    {
+        for (size_t i = 0; i < chunk->lines.size(); i++)
+        {
+            inputFileWithClearedLines.push_back(chunk->lines[i]);
+            lineNumberBeforeProcessing.push_back(lineBeforeProcessing + chunk->rawLineNumbers[i]);
+        }
+        lineBeforeProcessing += chunk->rawLines;
+        parallelScannerCalls += chunk->scannerCalls;
+    }
+
+    statistics.linesBeforeCleanup = lineBeforeProcessing;
+    statistics.linesAfterCleanup = inputFileWithClearedLines.size();
     return true;
 }
 
+void Parser::cleanupChunk(CleanupChunk &chunk)
+{
+    // lines are split at '\n' like getline does, a last line without one still counts
+    LineScanner scanner;
+    string buffer;
+    size_t start = 0;
+    while (start < chunk.text.size())
+    {
+        size_t end = chunk.text.find('\n', start);
+        end = end == string_view::npos ? chunk.text.size() : end;
+        string_view line = scanner.normalizeLine(chunk.text.substr(start, end - start), buffer);
+        start = end + 1;
+        chunk.rawLines++;
+
+        if (line.empty() || line == " ")
+        {
+            continue;
+        }
+
+        if (line.data() == buffer.data())
+        {
+            line = chunk.arena->store(line);
+        }
+        chunk.lines.push_back(line);
+        chunk.rawLineNumbers.push_back(chunk.rawLines);
+    }
+    chunk.scannerCalls = scanner.getCallCount();
+}
+
 bool Parser::firstPass()
 {
+    // classification runs over chunks of lines in parallel, the rest needs source order
+    const int CHUNK_LINES = 4096;
+    int lineCount = inputFileWithClearedLines.size();
+    int chunkCount = (lineCount + CHUNK_LINES - 1) / CHUNK_LINES;
+    vector<ScannedLine> scannedLines(lineCount);
+    vector<unsigned long> scannerCalls(chunkCount, 0);
+
+    runTasks(chunkCount, [this, &scannedLines, &scannerCalls, lineCount](int chunk)
+    {
+        LineScanner scanner;
+        int last = min(lineCount, (chunk + 1) * CHUNK_LINES);
+        for (int i = chunk * CHUNK_LINES; i < last; i++)
+        {
+            scanLine(&scanner, inputFileWithClearedLines[i], scannedLines[i]);
+        }
+        scannerCalls[chunk] = scanner.getCallCount();
+    });
+    for (int chunk = 0; chunk < chunkCount; chunk++)
+    {
+        parallelScannerCalls += scannerCalls[chunk];
+    }
+
     currentLine = 0;
+    reachedEnd = false;
     bool hasError = false;
 
-    for (string line : inputFileWithClearedLines)
+    for (int i = 0; i < lineCount; i++)
     {
         currentLine++;
-        RegexWrapper::Directive directive = regexWrapper->searchLine(line);
+        decodeLine(scannedLines[i], hasError);
+        if (reachedEnd)
+            break;
+    }
 
-        if (directive.type == RegexWrapper::LABEL)
+    return !hasError;
+}
+
+void Parser::scanLine(LineScanner *scanner, string_view line, ScannedLine &scanned)
+{
+    // everything about a line that does not depend on the lines before it
+    scanned.directive = scanner->searchLine(line);
+    scanned.label = scanned.directive;
+    if (scanned.directive.type == LineScanner::LABEL_WITH_INSTRUCTION)
+    {
+        scanned.directive = scanner->searchLine(scanned.label.param2);
+    }
+
+    switch (scanned.directive.type)
+    {
+    case LineScanner::SECTION:
+    case LineScanner::EQU:
+    case LineScanner::SKIP:
+    case LineScanner::END:
+    case LineScanner::GLOBAL:
+    case LineScanner::EXTERNAL:
+    case LineScanner::WORD:
+        break;
+
+    default:
+        if (scanned.label.type != LineScanner::LABEL)
         {
-            if (!handleLabel(directive.param1))
+            scanned.isInstruction = decodeInstruction(scanner, line, scanned.instruction);
+        }
+        break;
+    }
+}
+
+void Parser::decodeLine(string_view line, bool &hasError)
+{
+    ScannedLine scanned;
+    scanLine(lineScanner, line, scanned);
+    decodeLine(scanned, hasError);
+}
+
+void Parser::decodeLine(const ScannedLine &scanned, bool &hasError)
+{
+    const LineScanner::Directive &directive = scanned.directive;
+
+    if (scanned.label.type == LineScanner::LABEL)
+    {
+        if (!handleLabel(scanned.label.param1))
+        {
+            hasError = true;
+            return;
+        }
+    }
+    else
+    {
+        if (scanned.label.type == LineScanner::LABEL_WITH_INSTRUCTION)
+        {
+            if (!handleLabel(scanned.label.param1))
             {
                 hasError = true;
-                continue;
+                return;
             }
         }
-        else
+
+        switch (directive.type)
         {
-            if (directive.type == RegexWrapper::LABEL_WITH_INSTRUCTION)
+        case LineScanner::SECTION:
+        {
+            // like GNU as, a section that is opened again continues where it stopped
+            currentSection = internName(directive.param1);
+            activeSection = findSection(currentSection);
+            if (activeSection < 0)
             {
-                if (!handleLabel(directive.param1))
-                {
-                    hasError = true;
-                    continue;
-                }
-                directive = regexWrapper->searchLine(directive.param2);
+                addSymbol(0, true, true, false, currentSection, currentSection);
+                addSection(0, currentSection);
+                activeSection = sectionTable.size() - 1;
             }
+            locationCounter = sectionTable[activeSection].sectionSize;
 
-            switch (directive.type)
-            {
-            case RegexWrapper::SECTION:
+            DecodedLine decoded(SECTION_LINE, currentLine, locationCounter);
+            decoded.operand.symbol = currentSection;
+            decodedLines.push_back(decoded);
+            break;
+        }
+
+        case LineScanner::EQU:
+        {
+            int value;
+            const char *error = nullptr;
+            if (!parseLiteral(lineScanner, directive.param2, value, error))
             {
-                locationCounter = 0;
-                currentSection = directive.param1;
-                addSymbol(locationCounter, true, true, false, currentSection, currentSection);
-                addSection(0, currentSection);
+                addError(error, currentLine);
+                hasError = true;
                 break;
             }
 
-            case RegexWrapper::EQU:
+            int symbolName = internName(directive.param1);
+            Symbol *symbol = findSymbol(symbolName);
+            if (!symbol)
             {
-                bool hasSymbol = false;
-                string symbolName = directive.param1;
-                int value = convertToDecimalValueFromLiteral(directive.param2);
-                hasError = value == -1 ? true : hasError;
-                if (hasError)
-                    continue;
-                for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
-                {
-                    if (symbol->name == symbolName)
-                    {
-                        hasSymbol = true;
-                        if (symbol->isExtern)
-                        {
-                            addError("EQU directive cannot define extern symbol", currentLine);
-                            hasError = true;
-                            break;
-                        }
-
-                        if (symbol->isDefined)
-                        {
-                            addError("EQU directive cannot define an absolute symbol that is already defined", currentLine);
-                            hasError = true;
-                            break;
-                        }
-
-                        symbol->isDefined = true;
-                        symbol->section = ABSOLUTE;
-                        symbol->offset = value;
-                        updateAbsoluteSection(value);
-                    }
-                }
-
-                if (!hasSymbol)
-                {
-                    addSymbol(value, true, true, false, ABSOLUTE, symbolName);
-                    updateAbsoluteSection(value);
-                }
+                addSymbol(value, true, true, false, absoluteName, symbolName);
+                updateAbsoluteSection(value);
                 break;
             }
 
-            case RegexWrapper::SKIP:
+            if (symbol->isExtern)
             {
-                if (currentSection == "")
-                {
-                    addError("Skip has to be in section!", currentLine);
-                    hasError = true;
-                    continue;
-                }
+                addError("EQU directive cannot define extern symbol", currentLine);
+                hasError = true;
+                break;
+            }
 
-                int skipValue = convertToDecimalValueFromLiteral(directive.param1);
-                increaseSectionSizeAndCounter(skipValue, currentSection);
+            if (symbol->isDefined)
+            {
+                addError("EQU directive cannot define an absolute symbol that is already defined", currentLine);
+                hasError = true;
                 break;
             }
 
-            case RegexWrapper::END:
+            symbol->isDefined = true;
+            symbol->section = absoluteName;
+            symbol->offset = value;
+            updateAbsoluteSection(value);
+            break;
+        }
+
+        case LineScanner::SKIP:
+        {
+            if (currentSection == NamePool::EMPTY)
             {
-                return !hasError;
+                addError("Skip has to be in section!", currentLine);
+                hasError = true;
+                return;
             }
 
-            case RegexWrapper::GLOBAL:
+            int skipValue;
+            const char *error = nullptr;
+            if (!parseLiteral(lineScanner, directive.param1, skipValue, error))
+            {
+                addError(error, currentLine);
+                hasError = true;
+                return;
+            }
+            if (skipValue < 0)
             {
-                string symbolName;
-                stringstream ss(directive.param1);
-                while (getline(ss, symbolName, ','))
+                addError("Skip size cannot be negative!", currentLine);
+                hasError = true;
+                return;
+            }
+
+            DecodedLine decoded(SKIP_LINE, currentLine, locationCounter);
+            increaseSectionSizeAndCounter(skipValue);
+
+            decoded.operand = Operand(LITERAL, skipValue, "");
+            decodedLines.push_back(decoded);
+            break;
+        }
+
+        case LineScanner::END:
+        {
+            reachedEnd = true;
+            return;
+        }
+
+        case LineScanner::GLOBAL:
+        {
+            ListTokenizer symbols(directive.param1);
+            string_view symbolName;
+            while (symbols.next(symbolName))
+            {
+                int name = internName(symbolName);
+                Symbol *symbol = findSymbol(name);
+                if (symbol)
                 {
-                    bool symbolExist = false;
-                    for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
-                    {
-                        if (symbol->name == symbolName)
-                        {
-                            symbolExist = true;
-                            symbol->isLocal = false;
-                        }
-                    }
-                    if (!symbolExist)
-                    {
-                        addSymbol(0, false, false, false, UNDEFINED, symbolName);
-                    }
+                    symbol->isLocal = false;
+                }
+                else
+                {
+                    addSymbol(0, false, false, false, undefinedName, name);
                 }
-                break;
             }
+            break;
+        }
 
-            case RegexWrapper::EXTERNAL:
+        case LineScanner::EXTERNAL:
+        {
+            ListTokenizer symbols(directive.param1);
+            string_view symbolName;
+            while (symbols.next(symbolName))
             {
-                string symbolName;
-                stringstream ss(directive.param1);
-                while (getline(ss, symbolName, ','))
+                int name = internName(symbolName);
+                Symbol *symbol = findSymbol(name);
+                if (!symbol)
                 {
-                    bool symbolExist = false;
-                    for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
-                    {
-                        symbolExist = symbol->name == symbolName;
-                        if (symbolExist && symbol->isDefined)
-                        {
-                            addError("External redefinition of defined symbol", currentLine);
-                            hasError = true;
-                            break;
-                        }
-                    }
-                    if (!symbolExist)
-                    {
-                        addSymbol(0, false, false, true, UNDEFINED, symbolName);
-                    }
+                    addSymbol(0, false, false, true, undefinedName, name);
+                }
+                else if (symbol->isDefined)
+                {
+                    addError("External redefinition of defined symbol", currentLine);
+                    hasError = true;
                 }
-                break;
             }
-            case RegexWrapper::WORD:
+            break;
+        }
+        case LineScanner::WORD:
+        {
+            ListTokenizer words(directive.param1);
+            string_view word;
+            DecodedLine decoded(WORD_LINE, currentLine, locationCounter);
+            decoded.firstWord = wordOperands.size();
+            while (words.next(word))
             {
-                stringstream ss(directive.param1);
-                string symbol;
-                while (getline(ss, symbol, ','))
+                if (currentSection == NamePool::EMPTY)
                 {
-                    if (currentSection == "")
-                    {
-                        addError("Word directive has to be in a section!", currentLine);
-                        hasError = true;
-                        continue;
-                    }
-
-                    increaseSectionSizeAndCounter(2, currentSection);
+                    addError("Word directive has to be in a section!", currentLine);
+                    hasError = true;
+                    continue;
                 }
-                break;
+
+                const char *error = nullptr;
+                wordOperands.push_back(decodeOperand(lineScanner, word, error));
+                internOperand(wordOperands.back());
+                if (error)
+                {
+                    addError(error, currentLine);
+                    hasError = true;
+                }
+                decoded.wordCount++;
+                increaseSectionSizeAndCounter(2);
+            }
+            decodedLines.push_back(decoded);
+            break;
+        }
+
+        default:
+        {
+            if (currentSection == NamePool::EMPTY)
+            {
+                addError("Instruction has to be in a section!", currentLine);
+                hasError = true;
+                return;
+            }
+
+            DecodedLine decoded = scanned.instruction;
+            decoded.lineNumber = currentLine;
+            decoded.offset = locationCounter;
+            if (decoded.error)
+            {
+                addError(decoded.error, currentLine);
+                hasError = true;
             }
+            if (!scanned.isInstruction)
+            {
+                hasError = true;
+                return;
+            }
+
+            internOperand(decoded.operand);
+            increaseSectionSizeAndCounter(decoded.size);
+            decodedLines.push_back(decoded);
+            break;
+        }
+        }
+    }
+}
+
+bool Parser::decodeInstruction(LineScanner *scanner, string_view line, DecodedLine &decoded)
+{
+    // only looks at the line itself, so it is safe to run for many lines at once
+    LineScanner::Instruction instruction = scanner->searchInstruction(line);
+    const InstructionInfo *info = instruction.info;
+
+    switch (instruction.type)
+    {
+    case LineScanner::NO_OPERAND:
+        decoded.instrDescr = info->opcode;
+        decoded.size = info->size;
+        return true;
+
+    case LineScanner::ONE_OPERAND:
+        decoded.instrDescr = info->opcode;
+        decoded.regDescr = (decodeRegister(instruction.param2) << 4) + info->registerLow;
+        decoded.adrMode = info->addressMode;
+        decoded.size = info->size;
+        return true;
+
+    case LineScanner::ONE_OPERAND_JUMP:
+        return decodeJump(scanner, info, instruction.param2, decoded);
+
+    case LineScanner::TWO_OPERAND_LOAD_STORE:
+        return decodeLoadStore(scanner, info, instruction.param2, instruction.param3, decoded);
+
+    case LineScanner::TWO_OPERAND:
+        decoded.instrDescr = info->opcode;
+        decoded.regDescr = (decodeRegister(instruction.param2) << 4) + decodeRegister(instruction.param3);
+        decoded.size = info->size;
+        return true;
+
+    default:
+        decoded.error = "Instruction does not exists";
+        return false;
+    }
+}
+
+bool Parser::decodeJump(LineScanner *scanner, const InstructionInfo *info, string_view operand, DecodedLine &decoded)
+{
+    LineScanner::Jump jump = scanner->searchJump(operand);
+
+    decoded.instrDescr = info->opcode;
+    decoded.regDescr = 0xF0;
+    decoded.size = info->size;
+
+    switch (jump.type)
+    {
+    case LineScanner::JUMP_ABS:
+        decoded.regDescr += 0xF;
+        decoded.adrMode = 0;
+        decoded.operand = decodeOperand(scanner, operand, decoded.error);
+        break;
+
+    case LineScanner::JUMP_PC_RELATIVE:
+        decoded.regDescr += 0x7;
+        decoded.adrMode = 0x05;
+        decoded.operand = Operand(PC_RELATIVE_SYMBOL, 0, jump.param1);
+        break;
+
+    case LineScanner::JUMP_REG_DIR:
+        decoded.regDescr += decodeRegister(jump.param1);
+        decoded.adrMode = 0x01;
+        decoded.size = 3;
+        break;
+
+    case LineScanner::JUMP_REG_IND:
+        decoded.regDescr += decodeRegister(jump.param1);
+        decoded.adrMode = 0x02;
+        decoded.size = 3;
+        break;
+
+    case LineScanner::JUMP_REG_IND_DISPL:
+        decoded.regDescr += decodeRegister(jump.param1);
+        decoded.adrMode = 0x03;
+        decoded.operand = decodeOperand(scanner, jump.param2, decoded.error);
+        break;
+
+    case LineScanner::JUMP_MEM_DIR:
+        decoded.regDescr += 0xF;
+        decoded.adrMode = 0x04;
+        decoded.operand = decodeOperand(scanner, jump.param1, decoded.error);
+        break;
+
+    default:
+        decoded.error = "Addressing type is invalid";
+        return false;
+    }
+
+    return true;
+}
+
+bool Parser::decodeLoadStore(LineScanner *scanner, const InstructionInfo *info, string_view regD, string_view operand, DecodedLine &decoded)
+{
+    LineScanner::LoadStore loadStore = scanner->searchLoadStore(operand);
+
+    decoded.instrDescr = info->opcode;
+    decoded.regDescr = decodeRegister(regD) << 4;
+    decoded.size = info->size;
+
+    switch (loadStore.type)
+    {
+    case LineScanner::LOAD_STORE_ABS_SYMBOL:
+    case LineScanner::LOAD_STORE_ABS_VALUE:
+        decoded.regDescr += 0xF;
+        decoded.adrMode = 0;
+        decoded.operand = decodeOperand(scanner, loadStore.param1, decoded.error);
+        break;
+
+    case LineScanner::LOAD_STORE_PC_RELATIVE:
+        decoded.regDescr += 0x7;
+        decoded.adrMode = 0x03;
+        decoded.operand = Operand(PC_RELATIVE_SYMBOL, 0, loadStore.param1);
+        break;
+
+    case LineScanner::LOAD_STORE_REG_DIR:
+        decoded.regDescr += decodeRegister(loadStore.param1);
+        decoded.adrMode = 0x01;
+        decoded.size = 3;
+        break;
+
+    case LineScanner::LOAD_STORE_REG_IND:
+        decoded.regDescr += decodeRegister(loadStore.param1);
+        decoded.adrMode = 0x02;
+        decoded.size = 3;
+        break;
+
+    case LineScanner::LOAD_STORE_REG_IND_DISPL_SYMBOL:
+    case LineScanner::LOAD_STORE_REG_IND_DISPL_VALUE:
+        decoded.regDescr += decodeRegister(loadStore.param1);
+        decoded.adrMode = 0x03;
+        decoded.operand = decodeOperand(scanner, loadStore.param2, decoded.error);
+        break;
+
+    case LineScanner::LOAD_STORE_MEM_DIR_SYMBOL:
+    case LineScanner::LOAD_STORE_MEM_DIR_VALUE:
+        decoded.regDescr += 0xF;
+        decoded.adrMode = 0x04;
+        decoded.operand = decodeOperand(scanner, operand, decoded.error);
+        break;
+
+    default:
+        decoded.error = "Addressing type is invalid";
+        return false;
+    }
+
+    return true;
+}
+
+Parser::Operand Parser::decodeOperand(LineScanner *scanner, string_view operand, const char *&error)
+{
+    if (scanner->isSymbol(operand))
+    {
+        return Operand(SYMBOL, 0, operand);
+    }
+
+    int value;
+    parseLiteral(scanner, operand, value, error);
+    return Operand(LITERAL, value, "");
+}
+
+int Parser::decodeRegister(string_view reg)
+{
+    return reg == "psw" ? 8 : reg.at(1) - '0';
+}
+
+bool Parser::secondPass()
+{
+    // lines are grouped by section name, so a reopened section continues its group;
+    // lines before the first .section keep the empty name, as they always did
+    vector<SectionEncoder> encoders;
+    vector<int> encoderIndex(names->size(), -1);
+    encoders.push_back(SectionEncoder(NamePool::EMPTY));
+    encoderIndex[NamePool::EMPTY] = 0;
+    int current = 0;
+    for (int i = 0; i < (int)decodedLines.size(); i++)
+    {
+        if (decodedLines[i].type != SECTION_LINE)
+        {
+            encoders[current].lines.push_back(i);
+            continue;
+        }
+
+        int name = decodedLines[i].operand.symbol;
+        if (encoderIndex[name] < 0)
+        {
+            encoderIndex[name] = encoders.size();
+            encoders.push_back(SectionEncoder(name));
+        }
+        current = encoderIndex[name];
+    }
+
+    vector<char> failed(encoders.size(), 0);
+    runTasks(encoders.size(), [this, &encoders, &failed](int i)
+    {
+        for (vector<int>::iterator line = encoders[i].lines.begin(); line != encoders[i].lines.end(); line++)
+        {
+            failed[i] = !encodeLine(decodedLines[*line], encoders[i]) || failed[i];
+        }
+    });
+
+    // sections are committed in order of first appearance, errors go back to source order
+    size_t firstError = errors.size();
+    bool hasError = false;
+    for (int i = 0; i < (int)encoders.size(); i++)
+    {
+        commitEncoder(encoders[i]);
+        hasError = failed[i] || hasError;
+    }
+    stable_sort(errors.begin() + firstError, errors.end(), [](const AssemblerError &a, const AssemblerError &b)
+    {
+        return a.lineNumber < b.lineNumber;
+    });
+
+    return !hasError;
+}
 
-            default:
-            {
-                if (currentSection == "")
-                {
-                    addError("Instruction has to be in a section!", currentLine);
-                    hasError = true;
-                    continue;
-                }
+void Parser::commitEncoder(SectionEncoder &encoder)
+{
+    int index = findSection(encoder.section);
+    if (index >= 0)
+    {
+        Section &section = sectionTable[index];
+        for (vector<ObjectZeroFill>::iterator fill = encoder.zeroFills.begin(); fill != encoder.zeroFills.end(); fill++)
+        {
+            section.zeroFills.push_back(*fill);
+            section.zeroFills.back().dataOffset += section.data.size();
+        }
+        section.offsets.insert(section.offsets.end(), encoder.offsets.begin(), encoder.offsets.end());
+        section.data.insert(section.data.end(), encoder.data.begin(), encoder.data.end());
+        section.relocations.insert(section.relocations.end(), encoder.relocations.begin(), encoder.relocations.end());
+    }
+    errors.insert(errors.end(), encoder.errors.begin(), encoder.errors.end());
 
-                RegexWrapper::Instruction instruction = regexWrapper->searchInstruction(line);
+    encoder.data.clear();
+    encoder.offsets.clear();
+    encoder.zeroFills.clear();
+    encoder.relocations.clear();
+    encoder.errors.clear();
+}
 
-                switch (instruction.type)
-                {
-                case RegexWrapper::NO_OPERAND:
-                    increaseSectionSizeAndCounter(1, currentSection);
-                    break;
+bool Parser::encodeLine(const DecodedLine &decoded, SectionEncoder &encoder)
+{
+    // runs concurrently for different sections, so it only reads the parser tables
+    encoder.currentLine = decoded.lineNumber;
+    encoder.locationCounter = decoded.offset;
+    bool hasError = false;
 
-                case RegexWrapper::ONE_OPERAND:
-                {
-                    string operation = instruction.param1;
-                    if (operation == INT || operation == NOT)
-                    {
-                        increaseSectionSizeAndCounter(2, currentSection);
-                    }
-                    else if (operation == PUSH || operation == POP)
-                    {
-                        increaseSectionSizeAndCounter(3, currentSection);
-                    }
-                    break;
-                }
+    switch (decoded.type)
+    {
+    case SECTION_LINE:
+        encoder.section = decoded.operand.symbol;
+        break;
 
-                case RegexWrapper::ONE_OPERAND_JUMP:
-                {
-                    string operand = instruction.param2;
-                    RegexWrapper::Jump jump = regexWrapper->searchJump(operand);
-
-                    switch (jump.type)
-                    {
-                    case RegexWrapper::JUMP_ABS:
-                    case RegexWrapper::JUMP_PC_RELATIVE:
-                    case RegexWrapper::JUMP_REG_IND_DISPL:
-                    case RegexWrapper::JUMP_MEM_DIR:
-                        increaseSectionSizeAndCounter(5, currentSection);
-                        break;
-
-                    case RegexWrapper::JUMP_REG_DIR:
-                    case RegexWrapper::JUMP_REG_IND:
-                        increaseSectionSizeAndCounter(3, currentSection);
-                        break;
-
-                    default:
-                        addError("Addressing type is invalid", currentLine);
-                        hasError = true;
-                        continue;
-                    }
-
-                    break;
-                }
+    case SKIP_LINE:
+    {
+        // the zeros are not stored, the span records where they belong in the data
+        int skipValue = decoded.operand.value;
+        if (skipValue > 0)
+        {
+            encoder.offsets.push_back(encoder.locationCounter);
+            ObjectZeroFill fill;
+            fill.offset = encoder.locationCounter;
+            fill.size = skipValue;
+            fill.dataOffset = encoder.data.size();
+            encoder.zeroFills.push_back(fill);
+        }
+        encoder.locationCounter += skipValue;
+        break;
+    }
 
-                case RegexWrapper::TWO_OPERAND_LOAD_STORE:
+    case WORD_LINE:
+    {
+        for (int i = decoded.firstWord; i < decoded.firstWord + decoded.wordCount; i++)
+        {
+            const Operand &word = wordOperands[i];
+            if (word.type == SYMBOL)
+            {
+                int value = 0;
+                if (onePass)
                 {
-                    string operand = instruction.param3;
-                    RegexWrapper::LoadStore loadStore = regexWrapper->searchLoadStore(operand);
-
-                    switch (loadStore.type)
-                    {
-                    case RegexWrapper::LOAD_STORE_ABS_SYMBOL:
-                    case RegexWrapper::LOAD_STORE_ABS_VALUE:
-                    case RegexWrapper::LOAD_STORE_PC_RELATIVE:
-                    case RegexWrapper::LOAD_STORE_REG_IND_DISPL_SYMBOL:
-                    case RegexWrapper::LOAD_STORE_REG_IND_DISPL_VALUE:
-                    case RegexWrapper::LOAD_STORE_MEM_DIR_SYMBOL:
-                    case RegexWrapper::LOAD_STORE_MEM_DIR_VALUE:
-                        increaseSectionSizeAndCounter(5, currentSection);
-                        break;
-
-                    case RegexWrapper::LOAD_STORE_REG_DIR:
-                    case RegexWrapper::LOAD_STORE_REG_IND:
-                        increaseSectionSizeAndCounter(3, currentSection);
-                        break;
-
-                    default:
-                        addError("Addressing type is invalid", currentLine);
-                        hasError = true;
-                        continue;
-                    }
-
-                    break;
+                    addFixup(word, true, encoder);
                 }
-
-                case RegexWrapper::TWO_OPERAND:
-                    increaseSectionSizeAndCounter(2, currentSection);
-                    break;
-
-                default:
-                    addError("Instruction does not exists", currentLine);
+                else if (!resolveWordOperand(word, value, encoder))
+                {
                     hasError = true;
                     continue;
                 }
-
-                break;
+                insertWordDataInCurrentSection(encoder, value);
             }
+            else
+            {
+                insertWordDataInCurrentSection(encoder, word.value);
             }
+
+            encoder.locationCounter += 2;
+        }
+        break;
+    }
+
+    case INSTRUCTION_LINE:
+    {
+        int value = 0;
+        if (onePass && (decoded.operand.type == SYMBOL || decoded.operand.type == PC_RELATIVE_SYMBOL))
+        {
+            addFixup(decoded.operand, false, encoder);
+        }
+        else if (!resolveOperand(decoded.operand, value, encoder))
+        {
+            return false;
         }
+
+        insertInstructionInCurrentSection(encoder, decoded, value);
+        encoder.locationCounter += decoded.size;
+        break;
+    }
     }
 
     return !hasError;
 }
 
-bool Parser::secondPass()
+bool Parser::resolveOperand(const Operand &operand, int &value, SectionEncoder &encoder)
 {
-    currentLine = 0;
-    currentSection = "";
-    locationCounter = 0;
-    bool hasError = false;
+    if (operand.type == NONE || operand.type == LITERAL)
+    {
+        value = operand.value;
+        return true;
+    }
 
-    for (string line : inputFileWithClearedLines)
+    Symbol *symbol = findSymbol(operand.symbol);
+    if (!symbol)
     {
-        currentLine++;
-        RegexWrapper::Directive directive = regexWrapper->searchLine(line);
+        encoder.errors.push_back(AssemblerError("Symbol is not in symbol table", encoder.currentLine));
+        return false;
+    }
+
+    int symbolNumber = symbol - &symbolTable[0];
+    bool useSymbol = !symbol->isLocal || symbol->isExtern;
 
-        if (directive.type == RegexWrapper::LABEL)
+    if (operand.type == SYMBOL)
+    {
+        if (symbol->section == absoluteName)
+            value = symbol->offset;
+        else
         {
-            continue;
+            addRelocationValue(encoder, false, OBJECT_R_H_16, useSymbol ? symbolNumber : sectionSymbol(symbol->section), encoder.locationCounter + 4, 0);
+            value = (!symbol->isLocal || symbol->isExtern) ? 0 : symbol->offset;
+        }
+    }
+    else
+    {
+        if (symbol->section == absoluteName)
+        {
+            value = -2;
+            addRelocationValue(encoder, false, OBJECT_R_H_16_PC, symbolNumber, encoder.locationCounter + 4, 0);
         }
         else
         {
-            if (directive.type == RegexWrapper::LABEL_WITH_INSTRUCTION)
-            {
-                directive = regexWrapper->searchLine(directive.param2);
-            }
-
-            switch (directive.type)
-            {
-            case RegexWrapper::GLOBAL:
-            case RegexWrapper::EXTERNAL:
-            case RegexWrapper::EQU:
-                continue;
-
-            case RegexWrapper::SECTION:
-                locationCounter = 0;
-                currentSection = directive.param1;
-                break;
-
-            case RegexWrapper::SKIP:
-            {
-                string stringValue = directive.param1;
-                int skipValue = convertToDecimalValueFromLiteral(stringValue);
+            addRelocationValue(encoder, false, OBJECT_R_H_16_PC, useSymbol ? symbolNumber : (encoder.section == symbol->section ? OBJECT_NO_SYMBOL : sectionSymbol(symbol->section)), encoder.locationCounter + 4, 0);
+            value = (!symbol->isLocal || symbol->isExtern) ? -2 : (encoder.section == symbol->section ? symbol->offset - 2 - (encoder.locationCounter + 3) : symbol->offset - 2);
+        }
+    }
 
-                for (vector<Section>::iterator section = sectionTable.begin(); section != sectionTable.end(); section++)
-                {
-                    if (section->sectionName == currentSection)
-                    {
-                        section->offsets.push_back(locationCounter);
-                        for (int i = 0; i < skipValue; i++)
-                        {
-                            section->data.push_back(0);
-                        }
-                    }
-                }
-                locationCounter += skipValue;
-                break;
-            }
+    return true;
+}
 
-            case RegexWrapper::END:
-            {
-                return !hasError;
-            }
+bool Parser::createBinaryFile()
+{
+    ObjectFile object;
+    buildObjectFile(object);
 
-            case RegexWrapper::WORD:
-            {
-                stringstream ss(directive.param1);
-                string symbolOrNumber;
-                while (getline(ss, symbolOrNumber, ','))
-                {
-                    if (regexWrapper->isSymbol(symbolOrNumber))
-                    {
-                        bool symbolExist = false;
-                        for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
-                        {
-                            if (symbol->name == symbolOrNumber)
-                            {
-                                symbolExist = true;
-                                int value = symbol->section == ABSOLUTE || symbol->isDefined && symbol->isLocal ? symbol->offset : 0;
-                                insertWordDataInCurrentSection(value);
-                                if (symbol->section != ABSOLUTE)
-                                {
-                                    string name = symbol->isDefined && symbol->isLocal ? symbol->section : symbol->name;
-                                    addRelocationValue(true, currentSection, R_H_16, name, locationCounter, 0);
-                                }
-                            }
-                        }
-
-                        if (!symbolExist)
-                        {
-                            addError(".word used with undefined symbol!", currentLine);
-                            hasError = true;
-                            continue;
-                        }
-                    }
-                    else
-                    {
-                        char c = convertToDecimalValueFromLiteral(symbolOrNumber);
-                        insertWordDataInCurrentSection(c);
-                    }
-
-                    locationCounter += 2;
-                }
+    string bytes;
+    object.serialize(bytes);
 
-                break;
-            }
+    FileWriter *fw = new FileWriter(outputFilePath);
+    bool opened = fw->isFileOpened();
+    fw->writeBytes(bytes.data(), bytes.size());
+    statistics.bytesWritten = fw->getBytesWritten();
+    delete fw;
+    return opened;
+}
 
-            default:
-            {
-                RegexWrapper::Instruction instruction = regexWrapper->searchInstruction(line);
-                string operation = instruction.param1;
-                switch (instruction.type)
-                {
-                case RegexWrapper::NO_OPERAND:
-                {
-                    int operationCode = operation == HALT ? 0x00 : (operation == IRET ? 0x20 : 0x40);
-                    for (vector<Section>::iterator section = sectionTable.begin(); section != sectionTable.end(); section++)
-                    {
-                        if (section->sectionName == currentSection)
-                        {
-                            section->offsets.push_back(locationCounter);
-                            section->data.push_back(operationCode);
-                        }
-                    }
-                    locationCounter += 1;
-
-                    break;
-                }
+void Parser::buildObjectFile(ObjectFile &object)
+{
+    for (int i = 0; i < (int)sectionTable.size(); i++)
+    {
+        const vector<ObjectRelocation> &relocations = sectionTable[i].relocations;
+        ObjectSection entry;
+        entry.id = sectionTable[i].sectionId;
+        entry.name = object.addString(names->getName(sectionTable[i].name));
+        entry.size = sectionTable[i].sectionSize;
+        entry.dataSize = sectionTable[i].data.size();
+        entry.dataOffset = object.data.size();
+        entry.zeroFillCount = sectionTable[i].zeroFills.size();
+        entry.firstZeroFill = object.zeroFills.size();
+        entry.relocationCount = relocations.size();
+        entry.firstRelocation = object.relocations.size();
+        object.sections.push_back(entry);
+
+        object.relocations.insert(object.relocations.end(), relocations.begin(), relocations.end());
+        object.zeroFills.insert(object.zeroFills.end(), sectionTable[i].zeroFills.begin(), sectionTable[i].zeroFills.end());
+        object.data.insert(object.data.end(), sectionTable[i].data.begin(), sectionTable[i].data.end());
+    }
 
-                case RegexWrapper::ONE_OPERAND:
-                {
-                    string reg = instruction.param2;
-                    int registerNumber = reg == PSW ? 8 : reg.at(1) - '0';
-                    int operationCode;
-                    int registerOffset;
-                    if (operation == INT)
-                    {
-                        operationCode = 0x10;
-                        registerOffset = 15;
-                    }
-                    else if (operation == PUSH)
-                    {
-                        operationCode = 0xB0;
-                        registerOffset = 6;
-                    }
-                    else if (operation == POP)
-                    {
-                        operationCode = 0xA0;
-                        registerOffset = 6;
-                    }
-                    else
-                    {
-                        operationCode = 0x80;
-                        registerOffset = 15;
-                    }
-
-                    for (vector<Section>::iterator section = sectionTable.begin(); section != sectionTable.end(); section++)
-                    {
-                        if (section->sectionName == currentSection)
-                        {
-                            section->offsets.push_back(locationCounter);
-                            section->data.push_back(operationCode);
-                            section->data.push_back((registerNumber << 4) + registerOffset);
-
-                            if (operation == PUSH)
-                                section->data.push_back(0x12);
-                            else if (operation == POP)
-                                section->data.push_back(0x42);
-                        }
-                    }
-
-                    locationCounter += operation == INT || operation == NOT ? 2 : 3;
-
-                    break;
-                }
+    for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
+    {
+        ObjectSymbol entry = {};
+        entry.name = object.addString(names->getName(symbol->name));
+        entry.value = symbol->offset;
+        entry.section = findSection(symbol->section) >= 0 ? findSection(symbol->section) : 0;
+        entry.id = symbol->symbolId;
+        if (symbol->isLocal)
+            entry.type = OBJECT_SYMBOL_LOCAL;
+        else if (symbol->isDefined)
+            entry.type = OBJECT_SYMBOL_GLOBAL;
+        else if (symbol->isExtern)
+            entry.type = OBJECT_SYMBOL_EXTERN;
+        else
+            entry.type = OBJECT_SYMBOL_UNDEFINED;
+        object.symbols.push_back(entry);
+    }
+}
 
-                case RegexWrapper::ONE_OPERAND_JUMP:
-                {
-                    string operation = instruction.param1;
-                    string operand = instruction.param2;
-                    int instrDescr, regDescr = 0xF0, adrMode;
-                    RegexWrapper::Jump jump = regexWrapper->searchJump(operand);
-
-                    if (operation == CALL)
-                        instrDescr = 0x30;
-                    else if (operation == JMP)
-                        instrDescr = 0x50;
-                    else if (operation == JEQ)
-                        instrDescr = 0x51;
-                    else if (operation == JNE)
-                        instrDescr = 0x52;
-                    else if (operation == JGT)
-                        instrDescr = 0x53;
-
-                    switch (jump.type)
-                    {
-                    case RegexWrapper::JUMP_ABS:
-                    {
-                        if (regexWrapper->isSymbol(operand))
-                        {
-                            regDescr += 0xF;
-                            adrMode = 0;
-
-                            int value;
-                            bool symbolExist = false;
-                            for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
-                            {
-                                if (symbol->name == operand)
-                                {
-                                    symbolExist = true;
-
-                                    if (symbol->section == ABSOLUTE)
-                                        value = symbol->offset;
-                                    else
-                                    {
-                                        addRelocationValue(false, currentSection, R_H_16, (!symbol->isLocal || symbol->isExtern) ? symbol->name : symbol->section, locationCounter + 4, 0);
-                                        value = (!symbol->isLocal || symbol->isExtern) ? 0 : symbol->offset;
-                                    }
-                                }
-                            }
-                            if (!symbolExist)
-                            {
-                                addError("Symbol is not in symbol table", currentLine);
-                                hasError = true;
-                                continue;
-                            }
-
-                            insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, value, true);
-                            locationCounter += 5;
-                        }
-                        else
-                        {
-                            int value = convertToDecimalValueFromLiteral(operand);
-                            regDescr += 0xF;
-                            adrMode = 0;
-                            insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, value, true);
-                            locationCounter += 5;
-                        }
-
-                        break;
-                    }
-
-                    case RegexWrapper::JUMP_PC_RELATIVE:
-                    {
-                        operand = jump.param1;
-                        regDescr += 0x7;
-                        adrMode = 0x05;
-
-                        int value;
-                        bool symbolExist = false;
-                        for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
-                        {
-                            if (symbol->name == operand)
-                            {
-                                symbolExist = true;
-
-                                if (symbol->section == ABSOLUTE)
-                                {
-                                    value = -2;
-                                    addRelocationValue(false, currentSection, R_H_16_PC, symbol->name, locationCounter + 4, 0);
-                                }
-                                else
-                                {
-                                    addRelocationValue(false, currentSection, R_H_16_PC, (!symbol->isLocal || symbol->isExtern) ? symbol->name : (currentSection == symbol->section ? "" : symbol->section), locationCounter + 4, 0);
-                                    value = (!symbol->isLocal || symbol->isExtern) ? -2 : (currentSection == symbol->section ? symbol->offset - 2 - (locationCounter + 3) : symbol->offset - 2);
-                                }
-                            }
-                        }
-                        if (!symbolExist)
-                        {
-                            addError("Symbol is not in symbol table", currentLine);
-                            hasError = true;
-                            continue;
-                        }
-
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, value, true);
-                        locationCounter += 5;
-
-                        break;
-                    }
-                    case RegexWrapper::JUMP_REG_DIR:
-                    {
-                        regDescr += (jump.param1 == PSW ? 8 : jump.param1.at(1) - '0');
-                        adrMode = 0x01;
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, -1, false);
-                        locationCounter += 3;
-
-                        break;
-                    }
-
-                    case RegexWrapper::JUMP_REG_IND:
-                    {
-                        regDescr += (jump.param1 == PSW ? 8 : jump.param1.at(1) - '0');
-                        adrMode = 0x02;
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, -1, false);
-                        locationCounter += 3;
-
-                        break;
-                    }
-                    case RegexWrapper::JUMP_REG_IND_DISPL:
-                    {
-                        string displacement = jump.param2;
-                        regDescr += (jump.param1 == PSW ? 8 : jump.param1.at(1) - '0');
-                        adrMode = 0x03;
-                        int value;
-
-                        if (regexWrapper->isSymbol(displacement))
-                        {
-                            bool symbolExist = false;
-                            for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
-                            {
-                                if (symbol->name == displacement)
-                                {
-                                    symbolExist = true;
-
-                                    if (symbol->section == ABSOLUTE)
-                                        value = symbol->offset;
-                                    else
-                                    {
-                                        addRelocationValue(false, currentSection, R_H_16, (!symbol->isLocal || symbol->isExtern) ? symbol->name : symbol->section, locationCounter + 4, 0);
-                                        value = (!symbol->isLocal || symbol->isExtern) ? 0 : symbol->offset;
-                                    }
-                                }
-                            }
-
-                            if (!symbolExist)
-                            {
-                                addError("Symbol is not in symbol table", currentLine);
-                                hasError = true;
-                                continue;
-                            }
-                        }
-                        else
-                        {
-                            value = convertToDecimalValueFromLiteral(displacement);
-                        }
-
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, value, true);
-                        locationCounter += 5;
-
-                        break;
-                    }
-                    case RegexWrapper::JUMP_MEM_DIR:
-                    {
-                        operand = jump.param1;
-                        regDescr += 0xF;
-                        adrMode = 0x04;
-                        int value;
-
-                        if (regexWrapper->isSymbol(operand))
-                        {
-                            bool symbolExist = false;
-                            for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
-                            {
-                                if (symbol->name == operand)
-                                {
-                                    symbolExist = true;
-
-                                    if (symbol->section == ABSOLUTE)
-                                        value = symbol->offset;
-                                    else
-                                    {
-                                        addRelocationValue(false, currentSection, R_H_16, (!symbol->isLocal || symbol->isExtern) ? symbol->name : symbol->section, locationCounter + 4, 0);
-                                        value = (!symbol->isLocal || symbol->isExtern) ? 0 : symbol->offset;
-                                    }
-                                }
-                            }
-
-                            if (!symbolExist)
-                            {
-                                addError("Symbol is not in symbol table", currentLine);
-                                hasError = true;
-                                continue;
-                            }
-                        }
-                        else
-                        {
-                            value = convertToDecimalValueFromLiteral(operand);
-                        }
-
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, value, true);
-                        locationCounter += 5;
-
-                        break;
-                    }
-
-                    default:
-                        addError("Addressing type is invalid", currentLine);
-                        hasError = true;
-                        continue;
-                    }
-
-                    break;
-                }
+bool Parser::resolveWordOperand(const Operand &word, int &value, SectionEncoder &encoder)
+{
+    Symbol *symbol = findSymbol(word.symbol);
+    if (!symbol)
+    {
+        encoder.errors.push_back(AssemblerError(".word used with undefined symbol!", encoder.currentLine));
+        return false;
+    }
 
-                case RegexWrapper::TWO_OPERAND_LOAD_STORE:
-                {
-                    string operation = instruction.param1;
-                    string regD = instruction.param2;
-                    string operand = instruction.param3;
-                    RegexWrapper::LoadStore loadStore = regexWrapper->searchLoadStore(operand);
-
-                    int instrDescr, regDescr, adrMode;
-                    if (operation == LDR)
-                    {
-                        instrDescr = 0xA0;
-                    }
-                    else if (operation == STR)
-                    {
-                        instrDescr = 0xB0;
-                    }
-                    regDescr = (regD == PSW ? 0x8 : regD.at(1) - '0') << 4;
-
-                    switch (loadStore.type)
-                    {
-                    case RegexWrapper::LOAD_STORE_ABS_SYMBOL:
-                    {
-                        operand = loadStore.param1;
-                        regDescr += 0xF;
-                        adrMode = 0;
-                        int value;
-                        bool symbolExist = false;
-                        for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
-                        {
-                            if (symbol->name == operand)
-                            {
-                                symbolExist = true;
-
-                                if (symbol->section == ABSOLUTE)
-                                    value = symbol->offset;
-                                else
-                                {
-                                    addRelocationValue(false, currentSection, R_H_16, (!symbol->isLocal || symbol->isExtern) ? symbol->name : symbol->section, locationCounter + 4, 0);
-                                    value = (!symbol->isLocal || symbol->isExtern) ? 0 : symbol->offset;
-                                }
-                            }
-                        }
-
-                        if (!symbolExist)
-                        {
-                            addError("Symbol is not in symbol table", currentLine);
-                            hasError = true;
-                            continue;
-                        }
-
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, value, true);
-                        locationCounter += 5;
-
-                        break;
-                    }
-
-                    case RegexWrapper::LOAD_STORE_ABS_VALUE:
-                    {
-                        operand = loadStore.param1;
-                        int value = convertToDecimalValueFromLiteral(operand);
-                        regDescr += 0xF;
-                        adrMode = 0;
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, value, true);
-                        locationCounter += 5;
-
-                        break;
-                    }
-
-                    case RegexWrapper::LOAD_STORE_PC_RELATIVE:
-                    {
-                        operand = loadStore.param1;
-                        regDescr += 0x7;
-                        adrMode = 0x03;
-
-                        int value;
-                        bool symbolExist = false;
-                        for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
-                        {
-                            if (symbol->name == operand)
-                            {
-                                symbolExist = true;
-
-                                if (symbol->section == ABSOLUTE)
-                                {
-                                    value = -2;
-                                    addRelocationValue(false, currentSection, R_H_16_PC, symbol->name, locationCounter + 4, 0);
-                                }
-                                else
-                                {
-                                    addRelocationValue(false, currentSection, R_H_16_PC, (!symbol->isLocal || symbol->isExtern) ? symbol->name : (currentSection == symbol->section ? "" : symbol->section), locationCounter + 4, 0);
-                                    value = (!symbol->isLocal || symbol->isExtern) ? -2 : (currentSection == symbol->section ? symbol->offset - 2 - (locationCounter + 3) : symbol->offset - 2);
-                                }
-                            }
-                        }
-                        if (!symbolExist)
-                        {
-                            addError("Symbol is not in symbol table", currentLine);
-                            hasError = true;
-                            continue;
-                        }
-
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, value, true);
-                        locationCounter += 5;
-
-                        break;
-                    }
-
-                    case RegexWrapper::LOAD_STORE_REG_DIR:
-                    {
-                        regDescr += (loadStore.param1 == PSW ? 8 : loadStore.param1.at(1) - '0');
-                        adrMode = 0x01;
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, -1, false);
-                        locationCounter += 3;
-                        break;
-                    }
-
-                    case RegexWrapper::LOAD_STORE_REG_IND:
-                    {
-                        regDescr += (loadStore.param1 == PSW ? 8 : loadStore.param1.at(1) - '0');
-                        adrMode = 0x02;
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, -1, false);
-                        locationCounter += 3;
-                        break;
-                    }
-
-                    case RegexWrapper::LOAD_STORE_REG_IND_DISPL_SYMBOL:
-                    {
-                        string displacement = loadStore.param2;
-                        regDescr += (loadStore.param1 == PSW ? 8 : loadStore.param1.at(1) - '0');
-                        adrMode = 0x03;
-                        int value;
-                        bool symbolExist = false;
-                        for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
-                        {
-                            if (symbol->name == displacement)
-                            {
-                                symbolExist = true;
-
-                                if (symbol->section == ABSOLUTE)
-                                    value = symbol->offset;
-                                else
-                                {
-                                    addRelocationValue(false, currentSection, R_H_16, (!symbol->isLocal || symbol->isExtern) ? symbol->name : symbol->section, locationCounter + 4, 0);
-                                    value = (!symbol->isLocal || symbol->isExtern) ? 0 : symbol->offset;
-                                }
-                            }
-                        }
-
-                        if (!symbolExist)
-                        {
-                            addError("Symbol is not in symbol table", currentLine);
-                            hasError = true;
-                            continue;
-                        }
-
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, value, true);
-                        locationCounter += 5;
-
-                        break;
-                    }
-
-                    case RegexWrapper::LOAD_STORE_REG_IND_DISPL_VALUE:
-                    {
-                        string displacement = loadStore.param2;
-                        regDescr += (loadStore.param1 == PSW ? 8 : loadStore.param1.at(1) - '0');
-                        adrMode = 0x03;
-                        int value = convertToDecimalValueFromLiteral(displacement);
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, value, true);
-                        locationCounter += 5;
-
-                        break;
-                    }
-
-                    case RegexWrapper::LOAD_STORE_MEM_DIR_SYMBOL:
-                    {
-                        regDescr += 0xF;
-                        adrMode = 0x04;
-                        int value;
-                        bool symbolExist = false;
-                        for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
-                        {
-                            if (symbol->name == operand)
-                            {
-                                symbolExist = true;
-
-                                if (symbol->section == ABSOLUTE)
-                                    value = symbol->offset;
-                                else
-                                {
-                                    addRelocationValue(false, currentSection, R_H_16, (!symbol->isLocal || symbol->isExtern) ? symbol->name : symbol->section, locationCounter + 4, 0);
-                                    value = (!symbol->isLocal || symbol->isExtern) ? 0 : symbol->offset;
-                                }
-                            }
-                        }
-
-                        if (!symbolExist)
-                        {
-                            addError("Symbol is not in symbol table", currentLine);
-                            hasError = true;
-                            continue;
-                        }
-
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, value, true);
-                        locationCounter += 5;
-
-                        break;
-                    }
-
-                    case RegexWrapper::LOAD_STORE_MEM_DIR_VALUE:
-                    {
-                        regDescr += 0xF;
-                        adrMode = 0x04;
-                        int value = convertToDecimalValueFromLiteral(operand);
-                        insertJumpDataInCurrentSection(instrDescr, regDescr, adrMode, value, true);
-                        locationCounter += 5;
-
-                        break;
-                    }
-
-                    default:
-                        addError("Addressing type is invalid", currentLine);
-                        hasError = true;
-                        continue;
-                    }
-
-                    break;
-                }
+    value = symbol->section == absoluteName || (symbol->isDefined && symbol->isLocal) ? symbol->offset : 0;
+    if (symbol->section != absoluteName)
+    {
+        int relocationSymbol = symbol->isDefined && symbol->isLocal ? sectionSymbol(symbol->section) : symbol - &symbolTable[0];
+        addRelocationValue(encoder, true, OBJECT_R_H_16, relocationSymbol, encoder.locationCounter, 0);
+    }
+    return true;
+}
 
-                case RegexWrapper::TWO_OPERAND:
-                {
-                    string operation = instruction.param1;
-                    string regD = instruction.param2;
-                    string regS = instruction.param3;
-                    int instrDescr, regDescr;
-
-                    if (operation == XCHG)
-                        instrDescr = 0x60;
-                    else if (operation == ADD)
-                        instrDescr = 0x70;
-                    else if (operation == SUB)
-                        instrDescr = 0x71;
-                    else if (operation == MUL)
-                        instrDescr = 0x72;
-                    else if (operation == DIV)
-                        instrDescr = 0x73;
-                    else if (operation == CMP)
-                        instrDescr = 0x74;
-                    else if (operation == AND)
-                        instrDescr = 0x81;
-                    else if (operation == OR)
-                        instrDescr = 0x82;
-                    else if (operation == XOR)
-                        instrDescr = 0x83;
-                    else if (operation == TEST)
-                        instrDescr = 0x84;
-                    else if (operation == SHL)
-                        instrDescr = 0x90;
-                    else if (operation == SHR)
-                        instrDescr = 0x91;
-
-                    regDescr = (regD == PSW ? 0x8 : regD.at(1) - '0') << 4;
-                    regDescr += regS == PSW ? 0x8 : regS.at(1) - '0';
-
-                    for (vector<Section>::iterator section = sectionTable.begin(); section != sectionTable.end(); section++)
-                    {
-                        if (section->sectionName == currentSection)
-                        {
-                            section->offsets.push_back(locationCounter);
-                            section->data.push_back(instrDescr);
-                            section->data.push_back(regDescr);
-                        }
-                    }
-
-                    locationCounter += 2;
-
-                    break;
-                }
+void Parser::addFixup(const Operand &operand, bool isData, SectionEncoder &encoder)
+{
+    fixups.push_back(Fixup(operand, isData, encoder.section, encoder.locationCounter, encoder.currentLine));
+}
 
-                default:
-                    addError("Instruction does not exists", currentLine);
-                    hasError = true;
-                    continue;
-                }
+bool Parser::resolveFixups()
+{
+    // symbol bindings can still change until .end (a later .global or .equ),
+    // so every symbol operand is resolved here, in source order, which keeps
+    // the relocation order of the two pass assembly
+    bool hasError = false;
+    SectionEncoder encoder(NamePool::EMPTY);
 
-                break;
-            }
-            }
+    for (vector<Fixup>::iterator fixup = fixups.begin(); fixup != fixups.end(); fixup++)
+    {
+        currentSection = encoder.section = fixup->section;
+        encoder.locationCounter = fixup->locationCounter;
+        encoder.currentLine = fixup->lineNumber;
+
+        int value;
+        bool resolved = fixup->isData ? resolveWordOperand(fixup->operand, value, encoder) : resolveOperand(fixup->operand, value, encoder);
+        commitEncoder(encoder);
+        if (!resolved)
+        {
+            hasError = true;
+            continue;
         }
+
+        if (fixup->isData)
+            patchCurrentSection(fixup->locationCounter, value & 0xff, (value >> 8) & 0xff);
+        else
+            patchCurrentSection(fixup->locationCounter + 3, 0xff & (value >> 8), 0xff & value);
     }
 
     return !hasError;
 }
 
-void Parser::createTxtFile()
+void Parser::patchCurrentSection(int position, char first, char second)
+{
+    int index = findSection(currentSection);
+    if (index < 0)
+    {
+        return;
+    }
+
+    // zero fills before the position take no room in the data
+    Section &section = sectionTable[index];
+    vector<ObjectZeroFill>::iterator fill = upper_bound(section.zeroFills.begin(), section.zeroFills.end(), position, [](int offset, const ObjectZeroFill &zeroFill)
+    {
+        return offset < (int)zeroFill.offset;
+    });
+    if (fill != section.zeroFills.begin())
+    {
+        fill--;
+        position -= (int)(fill->offset + fill->size - fill->dataOffset);
+    }
+
+    if (position >= 0 && position + 1 < (int)section.data.size())
+    {
+        section.data[position] = first;
+        section.data[position + 1] = second;
+    }
+}
+
+bool Parser::createTxtFile()
 {
     FileWriter *fw = new FileWriter(outputFilePath);
+    if (!fw->isFileOpened())
+    {
+        delete fw;
+        return false;
+    }
 
     fw->writeLine("Section table:");
     fw->writeLine("Id\tName\t\tSize");
-    for (Section section : sectionTable)
+    for (const Section &section : sectionTable)
     {
-        fw->writeSection(section.sectionId, section.sectionName, section.sectionSize);
+        fw->writeSection(section.sectionId, names->getName(section.name), section.sectionSize);
     }
     fw->changeToDec();
     fw->addNewLine();
 
     fw->writeLine("Symbol table:");
     fw->writeLine("Value\tType\tSection\t\tName\t\tId");
-    for (Symbol symbol : symbolTable)
+    for (const Symbol &symbol : symbolTable)
     {
-        fw->writeSymbol(symbol.offset, symbol.isLocal, symbol.isDefined, symbol.isExtern, symbol.section, symbol.name, symbol.symbolId);
+        fw->writeSymbol(symbol.offset, symbol.isLocal, symbol.isDefined, symbol.isExtern, names->getName(symbol.section), names->getName(symbol.name), symbol.symbolId);
     }
     fw->changeToDec();
     fw->addNewLine();
 
-    for (Section section : sectionTable)
+    for (const Section &section : sectionTable)
     {
-        fw->writeLine("Relocation data <" + section.sectionName + ">:");
+        string sectionName(names->getName(section.name));
+        fw->writeLine("Relocation data <" + sectionName + ">:");
         fw->writeLine("Offset\tType\t\tDat/Ins\tSymbol\tSection name");
 
-        for (RelocationValue relocation : relocationTable)
+        for (const ObjectRelocation &relocation : section.relocations)
         {
-            if (relocation.sectionName == section.sectionName)
-            {
-                fw->writeRelocationValue(relocation.offset, relocation.type, relocation.isData, relocation.symbolName, relocation.sectionName);
-            }
+            string_view symbolName = relocation.symbol == OBJECT_NO_SYMBOL ? "" : names->getName(symbolTable[relocation.symbol].name);
+            fw->writeRelocationValue(relocation.offset, relocation.type == OBJECT_R_H_16_PC ? R_H_16_PC : R_H_16, relocation.isData, symbolName, sectionName);
         }
         fw->changeToDec();
 
-        fw->writeLine("Section data <" + section.sectionName + ">:");
+        fw->writeLine("Section data <" + sectionName + ">:");
         if (section.sectionSize == 0)
         {
             fw->changeToDec();
@@ -1110,167 +1147,304 @@ void Parser::createTxtFile()
             continue;
         }
 
-        fw->writeSectionData(section.offsets, section.data);
+        fw->writeSectionData(section.offsets, section.data, section.zeroFills);
 
         fw->changeToDec();
         fw->addNewLine();
     }
 
+    statistics.bytesWritten = fw->getBytesWritten();
     delete fw;
+    return true;
 }
 
-int Parser::convertToDecimalValueFromLiteral(string stringLiteral)
+bool Parser::parseLiteral(LineScanner *scanner, string_view stringLiteral, int &number, const char *&error)
 {
-    int number = -1;
-    RegexWrapper::Literal literal = regexWrapper->searchLiteral(stringLiteral);
-    switch (literal.type)
-    {
-    case RegexWrapper::HEXA_DECIMAL:
+    // the scanner has checked the digits, the value is accumulated here so that a
+    // literal that does not fit is reported instead of thrown or cut silently
+    number = -1;
+    LineScanner::Literal literal = scanner->searchLiteral(stringLiteral);
+    if (literal.type == LineScanner::ERROR)
     {
-        stringstream ss;
-        ss << literal.param1.substr(2);
-        ss >> hex >> number;
-        break;
+        error = "Bad literal format!";
+        return false;
     }
 
-    case RegexWrapper::DECIMAL:
-        number = stoi(literal.param1);
-        break;
-
-    default:
-        addError("Bad literal format!", currentLine);
-        break;
+    bool negative = literal.type == LineScanner::DECIMAL && literal.param1[0] == '-';
+    int base = literal.type == LineScanner::HEXA_DECIMAL ? 16 : 10;
+    string_view digits = literal.param1.substr(base == 16 ? 2 : (negative ? 1 : 0));
+    long long value = 0;
+    for (char c : digits)
+    {
+        int digit = c <= '9' ? c - '0' : (c >= 'a' ? c - 'a' : c - 'A') + 10;
+        value = value * base + digit;
+        if (value > 0xffffffffLL)
+        {
+            error = "Literal is too big!";
+            return false;
+        }
     }
 
-    return number;
+    value = negative ? -value : value;
+    if (value < -0x8000 || value > 0xffff)
+    {
+        error = "Literal does not fit in 16 bits!";
+        return false;
+    }
+    number = value;
+    return true;
 }
 
-void Parser::increaseSectionSizeAndCounter(int size, string name)
+void Parser::increaseSectionSizeAndCounter(int size)
 {
     locationCounter += size;
-    for (vector<Section>::iterator section = sectionTable.begin(); section != sectionTable.end(); section++)
-    {
-        if (section->sectionName == name)
-        {
-            section->sectionSize += size;
-        }
-    }
+    sectionTable[activeSection].sectionSize += size;
 }
 
-bool Parser::handleLabel(string symbolName)
+bool Parser::handleLabel(string_view symbolName)
 {
-    if (currentSection == "")
+    if (currentSection == NamePool::EMPTY)
     {
         addError("Label has to be defined in section!", currentLine);
         return false;
     }
 
-    bool hasSymbol = false;
-    for (vector<Symbol>::iterator symbol = symbolTable.begin(); symbol != symbolTable.end(); symbol++)
+    int name = internName(symbolName);
+    Symbol *symbol = findSymbol(name);
+    if (!symbol)
     {
-        if (symbol->name == symbolName)
-        {
-            hasSymbol = true;
-            if (symbol->isDefined)
-            {
-                addError("Symbol is already defined in this module!", currentLine);
-                return false;
-            }
-            if (symbol->isExtern)
-            {
-                addError("Symbol is already defined in another module!", currentLine);
-                return false;
-            }
-            symbol->isDefined = true;
-            symbol->offset = locationCounter;
-            symbol->section = currentSection;
-            break;
-        }
+        addSymbol(locationCounter, true, true, false, currentSection, name);
+        return true;
     }
 
-    if (!hasSymbol)
+    if (symbol->isDefined)
     {
-        addSymbol(locationCounter, true, true, false, currentSection, symbolName);
+        addError("Symbol is already defined in this module!", currentLine);
+        return false;
+    }
+    if (symbol->isExtern)
+    {
+        addError("Symbol is already defined in another module!", currentLine);
+        return false;
     }
+    symbol->isDefined = true;
+    symbol->offset = locationCounter;
+    symbol->section = currentSection;
     return true;
 }
 
 void Parser::updateAbsoluteSection(int value)
 {
-    for (vector<Section>::iterator section = sectionTable.begin(); section != sectionTable.end(); section++)
+    Section &section = sectionTable[findSection(absoluteName)];
+    section.offsets.push_back(section.sectionSize);
+    section.data.push_back(0xff & value);
+    section.data.push_back(0xff & (value >> 8));
+    section.sectionSize += 2;
+}
+
+void Parser::insertWordDataInCurrentSection(SectionEncoder &encoder, int value)
+{
+    // push upper 8 bits and then lower 8 bits, little endian
+    encoder.offsets.push_back(encoder.locationCounter);
+    encoder.data.push_back(value & 0xff);
+    encoder.data.push_back((value >> 8) & 0xff);
+}
+void Parser::insertInstructionInCurrentSection(SectionEncoder &encoder, const DecodedLine &decoded, int value)
+{
+    encoder.offsets.push_back(encoder.locationCounter);
+    encoder.data.push_back(decoded.instrDescr);
+    if (decoded.size > 1)
+        encoder.data.push_back(decoded.regDescr);
+    if (decoded.size > 2)
+        encoder.data.push_back(decoded.adrMode);
+    if (decoded.size > 3)
     {
-        if (section->sectionName == ABSOLUTE)
-        {
-            section->offsets.push_back(section->sectionSize);
-            section->data.push_back(0xff & value);
-            section->data.push_back(0xff & (value >> 8));
-            section->sectionSize += 2;
-        }
+        encoder.data.push_back(0xff & (value >> 8));
+        encoder.data.push_back(0xff & value);
+    }
+}
+
+void Parser::addError(const char *message, int lineNumber)
+{
+    errors.push_back(AssemblerError(message, lineNumber));
+}
+
+void Parser::addSymbol(int o, bool local, bool defined, bool ext, int s, int n)
+{
+    Symbol newSymbol(symbolId++, o, local, defined, ext, s, n);
+    // the first symbol with a given name wins the lookup, ids stay in insertion order
+    if (n >= (int)symbolIndex.size())
+    {
+        symbolIndex.resize(n + 1, -1);
     }
+    if (symbolIndex[n] < 0)
+    {
+        symbolIndex[n] = symbolTable.size();
+    }
+    symbolTable.push_back(newSymbol);
 }
 
-void Parser::insertWordDataInCurrentSection(int value)
+int Parser::internName(string_view name)
 {
-    for (vector<Section>::iterator section = sectionTable.begin(); section != sectionTable.end(); section++)
+    if (collectStatistics)
     {
-        if (section->sectionName == currentSection)
-        {
-            // push upper 8 bits and then lower 8 bits, little endian
-            section->offsets.push_back(locationCounter);
-            section->data.push_back(value & 0xff);
-            section->data.push_back((value >> 8) & 0xff);
-        }
+        countSymbolProbes(name);
     }
+    return names->intern(name);
 }
-void Parser::insertJumpDataInCurrentSection(int instrDescr, int regDescr, int adrMode, int value, bool includeValue)
+
+void Parser::internOperand(Operand &operand)
 {
-    for (vector<Section>::iterator section = sectionTable.begin(); section != sectionTable.end(); section++)
+    // after this the operand no longer points into the line, which may be a reused buffer
+    if (operand.type == SYMBOL || operand.type == PC_RELATIVE_SYMBOL)
     {
-        if (section->sectionName == currentSection)
-        {
-            section->offsets.push_back(locationCounter);
-            section->data.push_back(instrDescr);
-            section->data.push_back(regDescr);
-            section->data.push_back(adrMode);
-            if (includeValue)
-            {
-                section->data.push_back(0xff & (value >> 8));
-                section->data.push_back(0xff & value);
-            }
-        }
+        operand.symbol = internName(operand.text);
     }
+    operand.text = string_view();
 }
 
-void Parser::addError(string message, int lineNumber)
+Parser::Symbol *Parser::findSymbol(int name)
 {
-    AssemblerError error(message, lineNumber);
-    errors.push_back(error);
+    if (name < 0 || name >= (int)symbolIndex.size() || symbolIndex[name] < 0)
+    {
+        return nullptr;
+    }
+    return &symbolTable[symbolIndex[name]];
 }
 
-void Parser::addSymbol(int o, bool local, bool defined, bool ext, string s, string n)
+int Parser::findSection(int name)
 {
-    Symbol newSymbol(symbolId++, o, local, defined, ext, s, n);
-    symbolTable.push_back(newSymbol);
+    return name >= 0 && name < (int)sectionIndex.size() ? sectionIndex[name] : -1;
 }
 
-void Parser::addSection(int s, string n)
+void Parser::addSection(int s, int n)
 {
-    int id = n == ABSOLUTE ? -1 : sectionId++;
-    Section newSection(id, s, n);
+    int id = n == absoluteName ? -1 : sectionId++;
+    if (n >= (int)sectionIndex.size())
+    {
+        sectionIndex.resize(n + 1, -1);
+    }
+    sectionIndex[n] = sectionTable.size();
+    // the section symbol is always the one added just before, a .global of the same name may come earlier
+    Section newSection(id, s, n, symbolTable.size() - 1);
     sectionTable.push_back(newSection);
 }
 
-void Parser::addRelocationValue(bool data, string section, string t, string symbol, int o, int a)
+void Parser::addRelocationValue(SectionEncoder &encoder, bool data, ObjectRelocationType t, int symbol, int o, int a)
+{
+    ObjectRelocation relocation;
+    relocation.offset = o;
+    relocation.symbol = symbol;
+    relocation.type = t;
+    relocation.isData = data;
+    relocation.addend = a;
+    encoder.relocations.push_back(relocation);
+}
+
+int Parser::sectionSymbol(int name)
+{
+    int index = findSection(name);
+    return index >= 0 ? sectionTable[index].symbol : OBJECT_NO_SYMBOL;
+}
+
+void Parser::getDiagnostics(vector<Diagnostic> &diagnostics)
+{
+    for (vector<AssemblerError>::iterator it = errors.begin(); it != errors.end(); it++)
+    {
+        diagnostics.push_back(Diagnostic(sourceLineNumber(it->lineNumber), it->message));
+    }
+}
+
+void Parser::countSymbolProbes(string_view name)
+{
+    // only lookups by text hash a name, the passes look symbols up by handle after that
+    symbolLookups++;
+    symbolProbes += names->countProbes(name);
+}
+
+void Parser::setCollectStatistics(bool enabled)
+{
+    collectStatistics = enabled;
+}
+
+const Parser::Statistics &Parser::getStatistics()
+{
+    statistics.symbolLookups = symbolLookups;
+    statistics.symbolProbes = symbolProbes;
+    return statistics;
+}
+
+void Parser::printStatistics(ostream &out, bool json)
+{
+    getStatistics();
+    vector<int> relocationCounts(sectionTable.size(), 0);
+    for (int i = 0; i < (int)sectionTable.size(); i++)
+    {
+        relocationCounts[i] = sectionTable[i].relocations.size();
+    }
+
+    double totalTime = statistics.cleanupTime + statistics.firstPassTime + statistics.secondPassTime + statistics.outputTime;
+    double probesPerLookup = statistics.symbolLookups > 0 ? (double)statistics.symbolProbes / statistics.symbolLookups : 0;
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out << fixed << setprecision(3);
+
+    if (json)
+    {
+        string path;
+        for (char c : inputFilePath)
+        {
+            path += c == '"' || c == '\\' ? string("\\") + c : string(1, c);
+        }
+
+        out << "{\"file\": \"" << path << "\", \"time_ms\": {\"cleanup\": " << statistics.cleanupTime
+            << ", \"first_pass\": " << statistics.firstPassTime << ", \"second_pass\": " << statistics.secondPassTime
+            << ", \"output\": " << statistics.outputTime << ", \"total\": " << totalTime
+            << "}, \"lines_before_cleanup\": " << statistics.linesBeforeCleanup << ", \"lines_after_cleanup\": " << statistics.linesAfterCleanup
+            << ", \"scanner_calls\": " << statistics.scannerCalls << ", \"symbols\": " << symbolTable.size()
+            << ", \"symbol_lookups\": " << statistics.symbolLookups << ", \"symbol_probes\": " << statistics.symbolProbes
+            << ", \"relocations\": {";
+        for (int i = 0; i < (int)sectionTable.size(); i++)
+        {
+            out << (i > 0 ? ", " : "") << "\"" << names->getName(sectionTable[i].name) << "\": " << relocationCounts[i];
+        }
+        out << "}, \"bytes_written\": " << statistics.bytesWritten << "}" << endl;
+    }
+    else
+    {
+        out << "Statistics for " << inputFilePath << ":" << endl;
+        out << "  cleanup         " << statistics.cleanupTime << " ms" << endl;
+        out << "  first pass      " << statistics.firstPassTime << " ms" << endl;
+        out << "  second pass     " << statistics.secondPassTime << " ms" << endl;
+        out << "  output          " << statistics.outputTime << " ms" << endl;
+        out << "  total           " << totalTime << " ms" << endl;
+        out << "  lines           " << statistics.linesBeforeCleanup << " read, " << statistics.linesAfterCleanup << " after cleanup" << endl;
+        out << "  scanner calls   " << statistics.scannerCalls << endl;
+        out << "  symbols         " << symbolTable.size() << endl;
+        out << "  symbol lookups  " << statistics.symbolLookups << " (" << probesPerLookup << " probes per lookup)" << endl;
+        out << "  relocations    ";
+        for (int i = 0; i < (int)sectionTable.size(); i++)
+        {
+            out << " " << names->getName(sectionTable[i].name) << ": " << relocationCounts[i] << (i + 1 < (int)sectionTable.size() ? "," : "");
+        }
+        out << endl;
+        out << "  bytes written   " << statistics.bytesWritten << endl;
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+int Parser::sourceLineNumber(int lineNumber)
 {
-    RelocationValue relocationValue(data, section, t, symbol, o, a);
-    relocationTable.push_back(relocationValue);
+    return lineNumber >= 0 && lineNumber < (int)lineNumberBeforeProcessing.size() ? lineNumberBeforeProcessing[lineNumber] : 0;
 }
 
-void Parser::printErrors()
+void Parser::printErrors(ostream &messages)
 {
-    cout << "Assembler detects some errors:" << endl;
+    messages << "Assembler detects some errors:" << endl;
     for (vector<AssemblerError>::iterator it = errors.begin(); it != errors.end(); it++)
     {
-        cout << "Line " << lineNumberBeforeProcessing[it->lineNumber] << ":" << it->message << endl;
+        messages << "Line " << sourceLineNumber(it->lineNumber) << ":" << it->message << endl;
     }
 }
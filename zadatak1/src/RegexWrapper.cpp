@@ -12,191 +12,201 @@ RegexWrapper::~RegexWrapper()
 {
 }
 
-RegexWrapper::Directive RegexWrapper::searchLine(string line)
+string_view RegexWrapper::view(const smatch &match, size_t index)
+{
+    // submatches point into the searched string, which outlives the returned records
+    if (index >= match.size() || match[index].length() == 0)
+    {
+        return string_view();
+    }
+    return string_view(&*match[index].first, match[index].length());
+}
+
+LineScanner::Directive RegexWrapper::searchLine(const string &line)
 {
     smatch lineSmatch;
 
     if (regex_search(line, lineSmatch, regexLabel))
     {
-        return Directive(lineSmatch.str(1), lineSmatch.str(2), LABEL);
+        return LineScanner::Directive(view(lineSmatch, 1), view(lineSmatch, 2), LineScanner::LABEL);
     }
     else if (regex_search(line, lineSmatch, regexLabelWithInstruction))
     {
-        return Directive(lineSmatch.str(1), lineSmatch.str(2), LABEL_WITH_INSTRUCTION);
+        return LineScanner::Directive(view(lineSmatch, 1), view(lineSmatch, 2), LineScanner::LABEL_WITH_INSTRUCTION);
     }
     else if (regex_search(line, lineSmatch, regexSectionDirective))
     {
-        return Directive(lineSmatch.str(1), lineSmatch.str(2), SECTION);
+        return LineScanner::Directive(view(lineSmatch, 1), view(lineSmatch, 2), LineScanner::SECTION);
     }
     else if (regex_search(line, lineSmatch, regexEquDirective))
     {
-        return Directive(lineSmatch.str(1), lineSmatch.str(2), EQU);
+        return LineScanner::Directive(view(lineSmatch, 1), view(lineSmatch, 2), LineScanner::EQU);
     }
     else if (regex_search(line, lineSmatch, regexSkipDirective))
     {
-        return Directive(lineSmatch.str(1), lineSmatch.str(2), SKIP);
+        return LineScanner::Directive(view(lineSmatch, 1), view(lineSmatch, 2), LineScanner::SKIP);
     }
     else if (regex_search(line, lineSmatch, regexEndDirective))
     {
-        return Directive(lineSmatch.str(1), lineSmatch.str(2), END);
+        return LineScanner::Directive(view(lineSmatch, 1), view(lineSmatch, 2), LineScanner::END);
     }
     else if (regex_search(line, lineSmatch, regexGlobalDirective))
     {
-        return Directive(lineSmatch.str(1), lineSmatch.str(2), GLOBAL);
+        return LineScanner::Directive(view(lineSmatch, 1), view(lineSmatch, 2), LineScanner::GLOBAL);
     }
     else if (regex_search(line, lineSmatch, regexExternalDirective))
     {
-        return Directive(lineSmatch.str(1), lineSmatch.str(2), EXTERNAL);
+        return LineScanner::Directive(view(lineSmatch, 1), view(lineSmatch, 2), LineScanner::EXTERNAL);
     }
     else if (regex_search(line, lineSmatch, regexWordDirective))
     {
-        return Directive(lineSmatch.str(1), lineSmatch.str(2), WORD);
+        return LineScanner::Directive(view(lineSmatch, 1), view(lineSmatch, 2), LineScanner::WORD);
     }
     else
     {
-        return Directive(lineSmatch.str(1), lineSmatch.str(2), INSTRUCTION);
+        return LineScanner::Directive(view(lineSmatch, 1), view(lineSmatch, 2), LineScanner::INSTRUCTION);
     }
 }
 
-RegexWrapper::Instruction RegexWrapper::searchInstruction(string line)
+LineScanner::Instruction RegexWrapper::searchInstruction(const string &line)
 {
     smatch instructionSmatch;
     if (regex_search(line, instructionSmatch, regexNoOperandInstruction))
     {
-        return Instruction(instructionSmatch.str(1), instructionSmatch.str(2), instructionSmatch.str(3), NO_OPERAND);
+        return LineScanner::Instruction(view(instructionSmatch, 1), view(instructionSmatch, 2), view(instructionSmatch, 3), LineScanner::NO_OPERAND);
     }
     else if (regex_search(line, instructionSmatch, regexOneOperandRegisterInstruction))
     {
-        return Instruction(instructionSmatch.str(1), instructionSmatch.str(2), instructionSmatch.str(3), ONE_OPERAND);
+        return LineScanner::Instruction(view(instructionSmatch, 1), view(instructionSmatch, 2), view(instructionSmatch, 3), LineScanner::ONE_OPERAND);
     }
     else if (regex_search(line, instructionSmatch, regexOneOperandJump))
     {
-        return Instruction(instructionSmatch.str(1), instructionSmatch.str(2), instructionSmatch.str(3), ONE_OPERAND_JUMP);
+        return LineScanner::Instruction(view(instructionSmatch, 1), view(instructionSmatch, 2), view(instructionSmatch, 3), LineScanner::ONE_OPERAND_JUMP);
     }
     else if (regex_search(line, instructionSmatch, regexTwoOperandLoadStore))
     {
-        return Instruction(instructionSmatch.str(1), instructionSmatch.str(2), instructionSmatch.str(3), TWO_OPERAND_LOAD_STORE);
+        return LineScanner::Instruction(view(instructionSmatch, 1), view(instructionSmatch, 2), view(instructionSmatch, 3), LineScanner::TWO_OPERAND_LOAD_STORE);
     }
     else if (regex_search(line, instructionSmatch, regexTwoOperandRegisterInstruction))
     {
-        return Instruction(instructionSmatch.str(1), instructionSmatch.str(2), instructionSmatch.str(3), TWO_OPERAND);
+        return LineScanner::Instruction(view(instructionSmatch, 1), view(instructionSmatch, 2), view(instructionSmatch, 3), LineScanner::TWO_OPERAND);
     }
     else
     {
-        return Instruction(instructionSmatch.str(1), instructionSmatch.str(2), instructionSmatch.str(3), BAD_INSTRUCTION);
+        return LineScanner::Instruction(view(instructionSmatch, 1), view(instructionSmatch, 2), view(instructionSmatch, 3), LineScanner::BAD_INSTRUCTION);
     }
 }
 
-RegexWrapper::Jump RegexWrapper::searchJump(string operand)
+LineScanner::Jump RegexWrapper::searchJump(const string &operand)
 {
     smatch operandSmatch;
 
     if (regex_search(operand, operandSmatch, regexJumpAbsolute))
     {
-        return Jump(operandSmatch.str(1), operandSmatch.str(2), JUMP_ABS);
+        return LineScanner::Jump(view(operandSmatch, 1), view(operandSmatch, 2), LineScanner::JUMP_ABS);
     }
     else if (regex_search(operand, operandSmatch, regexJumPCRelative))
     {
-        return Jump(operandSmatch.str(1), operandSmatch.str(2), JUMP_PC_RELATIVE);
+        return LineScanner::Jump(view(operandSmatch, 1), view(operandSmatch, 2), LineScanner::JUMP_PC_RELATIVE);
     }
     else if (regex_search(operand, operandSmatch, regexJumpRegDir))
     {
-        return Jump(operandSmatch.str(1), operandSmatch.str(2), JUMP_REG_DIR);
+        return LineScanner::Jump(view(operandSmatch, 1), view(operandSmatch, 2), LineScanner::JUMP_REG_DIR);
     }
     else if (regex_search(operand, operandSmatch, regexJumpRegInd))
     {
-        return Jump(operandSmatch.str(1), operandSmatch.str(2), JUMP_REG_IND);
+        return LineScanner::Jump(view(operandSmatch, 1), view(operandSmatch, 2), LineScanner::JUMP_REG_IND);
     }
     else if (regex_search(operand, operandSmatch, regexJumpRegIndWithDisplacement))
     {
-        return Jump(operandSmatch.str(1), operandSmatch.str(2), JUMP_REG_IND_DISPL);
+        return LineScanner::Jump(view(operandSmatch, 1), view(operandSmatch, 2), LineScanner::JUMP_REG_IND_DISPL);
     }
     else if (regex_search(operand, operandSmatch, regexJumpMemDir))
     {
-        return Jump(operandSmatch.str(1), operandSmatch.str(2), JUMP_MEM_DIR);
+        return LineScanner::Jump(view(operandSmatch, 1), view(operandSmatch, 2), LineScanner::JUMP_MEM_DIR);
     }
     else
     {
-        return Jump(operandSmatch.str(1), operandSmatch.str(2), BAD_JUMP);
+        return LineScanner::Jump(view(operandSmatch, 1), view(operandSmatch, 2), LineScanner::BAD_JUMP);
     }
 }
 
-RegexWrapper::LoadStore RegexWrapper::searchLoadStore(string operand)
+LineScanner::LoadStore RegexWrapper::searchLoadStore(const string &operand)
 {
     smatch operandSmatch;
 
     if (regex_search(operand, operandSmatch, regexLoadStoreAbsolute))
     {
-        string op = operandSmatch.str(1);
-        if (regex_match(op, regexSymbol))
+        string_view op = view(operandSmatch, 1);
+        if (regex_match(op.begin(), op.end(), regexSymbol))
         {
-            return LoadStore(op, operandSmatch.str(2), LOAD_STORE_ABS_SYMBOL);
+            return LineScanner::LoadStore(op, view(operandSmatch, 2), LineScanner::LOAD_STORE_ABS_SYMBOL);
         }
         else
         {
-            return LoadStore(op, operandSmatch.str(2), LOAD_STORE_ABS_VALUE);
+            return LineScanner::LoadStore(op, view(operandSmatch, 2), LineScanner::LOAD_STORE_ABS_VALUE);
         }
     }
     else if (regex_search(operand, operandSmatch, regexLoadStorePCRelative))
     {
-        return LoadStore(operandSmatch.str(1), operandSmatch.str(2), LOAD_STORE_PC_RELATIVE);
+        return LineScanner::LoadStore(view(operandSmatch, 1), view(operandSmatch, 2), LineScanner::LOAD_STORE_PC_RELATIVE);
     }
     else if (regex_search(operand, operandSmatch, regexLoadStoreRegDir))
     {
-        return LoadStore(operandSmatch.str(1), operandSmatch.str(2), LOAD_STORE_REG_DIR);
+        return LineScanner::LoadStore(view(operandSmatch, 1), view(operandSmatch, 2), LineScanner::LOAD_STORE_REG_DIR);
     }
     else if (regex_search(operand, operandSmatch, regexLoadStoreRegInd))
     {
-        return LoadStore(operandSmatch.str(1), operandSmatch.str(2), LOAD_STORE_REG_IND);
+        return LineScanner::LoadStore(view(operandSmatch, 1), view(operandSmatch, 2), LineScanner::LOAD_STORE_REG_IND);
     }
     else if (regex_search(operand, operandSmatch, regexLoadStoreRegIndWithDisplacement))
     {
-        string displacement = operandSmatch.str(2);
+        string_view displacement = view(operandSmatch, 2);
 
-        if (regex_match(displacement, regexSymbol))
+        if (regex_match(displacement.begin(), displacement.end(), regexSymbol))
         {
-            return LoadStore(operandSmatch.str(1), displacement, LOAD_STORE_REG_IND_DISPL_SYMBOL);
+            return LineScanner::LoadStore(view(operandSmatch, 1), displacement, LineScanner::LOAD_STORE_REG_IND_DISPL_SYMBOL);
         }
         else
         {
-            return LoadStore(operandSmatch.str(1), displacement, LOAD_STORE_REG_IND_DISPL_VALUE);
+            return LineScanner::LoadStore(view(operandSmatch, 1), displacement, LineScanner::LOAD_STORE_REG_IND_DISPL_VALUE);
         }
     }
     else if (regex_search(operand, operandSmatch, regexLoadStoreMemDir))
     {
         if (regex_match(operand, regexSymbol))
         {
-            return LoadStore(operand, operandSmatch.str(2), LOAD_STORE_MEM_DIR_SYMBOL);
+            return LineScanner::LoadStore(operand, view(operandSmatch, 2), LineScanner::LOAD_STORE_MEM_DIR_SYMBOL);
         }
         else
         {
-            return LoadStore(operand, operandSmatch.str(2), LOAD_STORE_MEM_DIR_VALUE);
+            return LineScanner::LoadStore(operand, view(operandSmatch, 2), LineScanner::LOAD_STORE_MEM_DIR_VALUE);
         }
     }
     else
     {
-        return LoadStore(operandSmatch.str(1), operandSmatch.str(2), BAD_LOAD_STORE);
+        return LineScanner::LoadStore(view(operandSmatch, 1), view(operandSmatch, 2), LineScanner::BAD_LOAD_STORE);
     }
 }
 
-RegexWrapper::Literal RegexWrapper::searchLiteral(string literal)
+LineScanner::Literal RegexWrapper::searchLiteral(const string &literal)
 {
     smatch numberSmatch;
     if (regex_search(literal, numberSmatch, regexHexaDecimal))
     {
-        return Literal(numberSmatch.str(1), HEXA_DECIMAL);
+        return LineScanner::Literal(view(numberSmatch, 1), LineScanner::HEXA_DECIMAL);
     }
     else if (regex_search(literal, numberSmatch, regexDecimal))
     {
-        return Literal(numberSmatch.str(1), DECIMAL);
+        return LineScanner::Literal(view(numberSmatch, 1), LineScanner::DECIMAL);
     }
     else
     {
-        return Literal(numberSmatch.str(1), ERROR);
+        return LineScanner::Literal(view(numberSmatch, 1), LineScanner::ERROR);
     }
 }
 
-bool RegexWrapper::isSymbol(string operand)
+bool RegexWrapper::isSymbol(const string &operand)
 {
     return regex_match(operand, regexSymbol);
 }
@@ -0,0 +1,37 @@
+#include <cstring>
+
+#include "../inc/StringArena.h"
+
+using namespace std;
+
+StringArena::StringArena() : used(0), capacity(0)
+{
+}
+
+StringArena::~StringArena()
+{
+    for (vector<char *>::iterator block = blocks.begin(); block != blocks.end(); block++)
+    {
+        delete[] *block;
+    }
+}
+
+string_view StringArena::store(string_view text)
+{
+    if (text.empty())
+    {
+        return string_view();
+    }
+
+    if (used + text.size() > capacity)
+    {
+        capacity = text.size() > BLOCK_SIZE ? text.size() : BLOCK_SIZE;
+        blocks.push_back(new char[capacity]);
+        used = 0;
+    }
+
+    char *destination = blocks.back() + used;
+    memcpy(destination, text.data(), text.size());
+    used += text.size();
+    return string_view(destination, text.size());
+}
@@ -0,0 +1,96 @@
+#include "../inc/WorkerPool.h"
+
+using namespace std;
+
+WorkerPool::WorkerPool(int threadCount) : job(nullptr), taskCount(0), activeWorkers(0), nextTask(0), generation(0), stopping(false)
+{
+    // the calling thread is one of the threads
+    threadCount = threadCount > 0 ? threadCount : getDefaultThreadCount();
+    for (int i = 1; i < threadCount; i++)
+    {
+        workers.push_back(thread(&WorkerPool::workerLoop, this));
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        lock_guard<mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (vector<thread>::iterator worker = workers.begin(); worker != workers.end(); worker++)
+    {
+        worker->join();
+    }
+}
+
+int WorkerPool::getDefaultThreadCount()
+{
+    int cores = thread::hardware_concurrency();
+    return cores > 0 ? cores : 1;
+}
+
+int WorkerPool::getThreadCount()
+{
+    return workers.size() + 1;
+}
+
+void WorkerPool::forEach(int count, const function<void(int)> &task)
+{
+    if (workers.empty() || count <= 1)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(jobMutex);
+        job = &task;
+        taskCount = count;
+        nextTask = 0;
+        activeWorkers = workers.size();
+        generation++;
+    }
+    jobReady.notify_all();
+
+    runTasks();
+
+    unique_lock<mutex> lock(jobMutex);
+    jobDone.wait(lock, [this] { return activeWorkers == 0; });
+    job = nullptr;
+}
+
+void WorkerPool::runTasks()
+{
+    for (int i = nextTask++; i < taskCount; i = nextTask++)
+    {
+        (*job)(i);
+    }
+}
+
+void WorkerPool::workerLoop()
+{
+    unsigned long seenGeneration = 0;
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(jobMutex);
+            jobReady.wait(lock, [this, seenGeneration] { return stopping || generation != seenGeneration; });
+            if (stopping)
+                return;
+            seenGeneration = generation;
+        }
+
+        runTasks();
+
+        lock_guard<mutex> lock(jobMutex);
+        if (--activeWorkers == 0)
+        {
+            jobDone.notify_one();
+        }
+    }
+}
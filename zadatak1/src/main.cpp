@@ -1,20 +1,188 @@
 #include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <vector>
 
 #include "../inc/Parser.h"
+#include "../inc/WorkerPool.h"
 
 using namespace std;
 
+struct BatchJob
+{
+    string inputFile, outputFile, messages;
+    bool success;
+    BatchJob(const string &i, const string &o) : inputFile(i), outputFile(o), success(false) {}
+};
+
+string outputPathInDirectory(string outputDirectory, string inputFile)
+{
+    size_t slash = inputFile.find_last_of('/');
+    string name = slash == string::npos ? inputFile : inputFile.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    name = dot == string::npos || dot == 0 ? name : name.substr(0, dot);
+
+    if (outputDirectory != "" && outputDirectory.back() != '/')
+    {
+        outputDirectory += '/';
+    }
+    return outputDirectory + name + ".o";
+}
+
+enum StatisticsMode
+{
+    NO_STATISTICS,
+    TEXT_STATISTICS,
+    JSON_STATISTICS
+};
+
+int runBatch(vector<BatchJob> &jobs, int threadCount, bool onePass, Parser::OutputFormat outputFormat, StatisticsMode statisticsMode)
+{
+    // every file gets its own parser and message buffer, the buffers are printed in input order
+    WorkerPool *pool = new WorkerPool(threadCount);
+    pool->forEach(jobs.size(), [&jobs, onePass, outputFormat, statisticsMode](int i)
+    {
+        stringstream messages;
+        Parser *parser = new Parser();
+        parser->setFilesPath(jobs[i].inputFile, jobs[i].outputFile);
+        parser->setOnePass(onePass);
+        parser->setOutputFormat(outputFormat);
+        parser->setCollectStatistics(statisticsMode != NO_STATISTICS);
+        jobs[i].success = parser->compile(messages);
+        if (statisticsMode != NO_STATISTICS)
+        {
+            parser->printStatistics(messages, statisticsMode == JSON_STATISTICS);
+        }
+        jobs[i].messages = messages.str();
+        delete parser;
+    });
+    delete pool;
+
+    int failed = 0;
+    for (vector<BatchJob>::iterator job = jobs.begin(); job != jobs.end(); job++)
+    {
+        if (job->messages != "")
+        {
+            cout << job->inputFile << ":" << endl
+                 << job->messages;
+        }
+        failed += job->success ? 0 : 1;
+    }
+
+    if (failed > 0)
+    {
+        cout << failed << " of " << jobs.size() << " files failed" << endl;
+        return 1;
+    }
+    return 0;
+}
+
 int main(int argc, const char *argv[])
 {
-    string argument = argv[1];
+    string outputFile, outputDirectory;
+    vector<string> inputFiles;
+    bool onePass = false;
+    int threadCount = 0;
+    StatisticsMode statisticsMode = NO_STATISTICS;
+    Parser::OutputFormat outputFormat = Parser::TEXT;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string argument = argv[i];
+        if (argument == "-o" && i + 1 < argc)
+        {
+            outputFile = argv[++i];
+        }
+        else if (argument == "-d" && i + 1 < argc)
+        {
+            outputDirectory = argv[++i];
+        }
+        else if (argument == "-j" && i + 1 < argc)
+        {
+            threadCount = atoi(argv[++i]);
+        }
+        else if (argument == "--one-pass")
+        {
+            onePass = true;
+        }
+        else if (argument == "--stats")
+        {
+            statisticsMode = TEXT_STATISTICS;
+        }
+        else if (argument == "--stats=json")
+        {
+            statisticsMode = JSON_STATISTICS;
+        }
+        else if (argument == "--format=binary")
+        {
+            outputFormat = Parser::BINARY;
+        }
+        else if (argument == "--format=text")
+        {
+            outputFormat = Parser::TEXT;
+        }
+        else
+        {
+            inputFiles.push_back(argument);
+        }
+    }
 
-    if (argument != "-o")
+    // batch mode: several inputs, an output directory (-d) or input=output pairs
+    bool batch = inputFiles.size() > 1 || outputDirectory != "";
+    for (vector<string>::iterator input = inputFiles.begin(); input != inputFiles.end(); input++)
+    {
+        batch = batch || input->find('=') != string::npos;
+    }
+
+    if (batch)
+    {
+        if (outputFile != "")
+        {
+            cout << "Option -o takes a single input, use -d <directory> or input=output in batch mode!" << endl;
+            return -1;
+        }
+
+        vector<BatchJob> jobs;
+        for (vector<string>::iterator input = inputFiles.begin(); input != inputFiles.end(); input++)
+        {
+            size_t separator = input->find('=');
+            if (separator != string::npos)
+            {
+                jobs.push_back(BatchJob(input->substr(0, separator), input->substr(separator + 1)));
+            }
+            else if (outputDirectory != "")
+            {
+                jobs.push_back(BatchJob(*input, outputPathInDirectory(outputDirectory, *input)));
+            }
+            else
+            {
+                cout << "Output file does not exists for input: " << *input << endl;
+                return -1;
+            }
+        }
+        return runBatch(jobs, threadCount, onePass, outputFormat, statisticsMode);
+    }
+
+    if (outputFile == "")
     {
         cout << "Output file does not exists!" << endl;
         return -1;
     }
 
-    Parser *parser = Parser::getInstance();
-    parser->setFilesPath(argv[3], argv[2]);
-    parser->compile();
-}
\ No newline at end of file
+    // a single file uses the pool inside the parser, a batch uses it across files
+    WorkerPool *pool = new WorkerPool(threadCount);
+    Parser *parser = new Parser();
+    parser->setFilesPath(inputFiles.empty() ? "" : inputFiles.back(), outputFile);
+    parser->setWorkerPool(pool);
+    parser->setOnePass(onePass);
+    parser->setOutputFormat(outputFormat);
+    parser->setCollectStatistics(statisticsMode != NO_STATISTICS);
+    bool success = parser->compile();
+    if (statisticsMode != NO_STATISTICS)
+    {
+        parser->printStatistics(cout, statisticsMode == JSON_STATISTICS);
+    }
+    delete parser;
+    delete pool;
+    return success ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstdlib>
+#include <cstdio>
+
+#include "../inc/Assembler.h"
+#include "../inc/FileReader.h"
+
+using namespace std;
+
+// The library API has to give what the command line gives: the serialized object of a
+// successful assembly is the binary output of asembler and the diagnostics of a failed
+// one are its messages. Two Assemblers, one of them in one pass mode, run at the same
+// time over the same inputs, from the file and from memory.
+// Usage: assembler_test <source>...
+
+struct Expected
+{
+    string source, object, messages;
+    bool success;
+};
+
+int checks = 0;
+int mismatches = 0;
+
+string readFile(const string &path)
+{
+    FileReader reader(path);
+    string_view contents = reader.getContents();
+    return string(contents.data(), contents.size());
+}
+
+string describe(const AssemblerResult &result)
+{
+    if (result.success)
+    {
+        string bytes;
+        result.object.serialize(bytes);
+        return bytes;
+    }
+    string messages = "Assembler detects some errors:\n";
+    for (vector<Parser::Diagnostic>::const_iterator diagnostic = result.diagnostics.begin(); diagnostic != result.diagnostics.end(); diagnostic++)
+    {
+        messages += "Line " + to_string(diagnostic->lineNumber) + ":" + diagnostic->message + "\n";
+    }
+    return messages;
+}
+
+void runAll(Assembler *assembler, const vector<Expected> &expected, bool reversed, vector<string> &failures)
+{
+    for (int round = 0; round < 4; round++)
+    {
+        for (int n = 0; n < (int)expected.size(); n++)
+        {
+            const Expected &input = expected[reversed ? expected.size() - 1 - n : n];
+            AssemblerResult fromFile = assembler->assembleFile(input.source);
+            AssemblerResult fromMemory = assembler->assembleSource(readFile(input.source));
+            string wanted = input.success ? input.object : input.messages;
+            if (fromFile.success != input.success || describe(fromFile) != wanted)
+                failures.push_back(input.source + ": assembleFile differs from asembler");
+            if (fromMemory.success != input.success || describe(fromMemory) != wanted)
+                failures.push_back(input.source + ": assembleSource differs from asembler");
+        }
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    string output = "tests/assembler_test.o", messages = "tests/assembler_test.txt";
+    vector<Expected> expected;
+    for (int i = 1; i < argc; i++)
+    {
+        remove(output.c_str());
+        string command = "./asembler --format=binary -o " + output + " " + argv[i] + " > " + messages;
+        Expected input;
+        input.source = argv[i];
+        input.success = system(command.c_str()) == 0;
+        input.object = input.success ? readFile(output) : "";
+        input.messages = readFile(messages);
+        expected.push_back(input);
+    }
+    remove(output.c_str());
+    remove(messages.c_str());
+
+    Assembler *twoPass = new Assembler();
+    Assembler *onePass = new Assembler();
+    onePass->setOnePass(true);
+    vector<string> twoPassFailures, onePassFailures;
+    thread first(runAll, twoPass, cref(expected), false, ref(twoPassFailures));
+    thread second(runAll, onePass, cref(expected), true, ref(onePassFailures));
+    first.join();
+    second.join();
+    delete twoPass;
+    delete onePass;
+
+    checks = expected.size() * 4 * 2 * 2;
+    mismatches = twoPassFailures.size() + onePassFailures.size();
+    for (vector<string>::iterator failure = twoPassFailures.begin(); failure != twoPassFailures.end(); failure++)
+        cout << *failure << endl;
+    for (vector<string>::iterator failure = onePassFailures.begin(); failure != onePassFailures.end(); failure++)
+        cout << *failure << " (one pass)" << endl;
+
+    cout << "Assembler: " << checks << " checks, " << mismatches << " mismatches" << endl;
+    return mismatches == 0 ? 0 : 1;
+}
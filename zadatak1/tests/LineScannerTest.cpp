@@ -0,0 +1,196 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+
+#include "../inc/LineScanner.h"
+#include "../inc/RegexWrapper.h"
+#include "../inc/FileReader.h"
+
+using namespace std;
+
+// Differential test: every cleanup and classification done by LineScanner has to
+// be identical to the one produced by the original regex patterns in RegexWrapper.
+
+LineScanner scanner;
+RegexWrapper regexWrapper;
+int checks = 0;
+int mismatches = 0;
+
+void report(const string &function, const string &input, const string &expected, const string &actual)
+{
+    mismatches++;
+    cout << function << "(\"" << input << "\")" << endl;
+    cout << "\tregex:   " << expected << endl;
+    cout << "\tscanner: " << actual << endl;
+}
+
+string describe(int type, string_view p1, string_view p2 = "", string_view p3 = "")
+{
+    return to_string(type) + " [" + string(p1) + "] [" + string(p2) + "] [" + string(p3) + "]";
+}
+
+void compare(const string &function, const string &input, const string &expected, const string &actual)
+{
+    checks++;
+    if (expected != actual)
+    {
+        report(function, input, expected, actual);
+    }
+}
+
+void checkText(const string &text)
+{
+    LineScanner::Directive d1 = regexWrapper.searchLine(text), d2 = scanner.searchLine(text);
+    compare("searchLine", text, describe(d1.type, d1.param1, d1.param2), describe(d2.type, d2.param1, d2.param2));
+
+    LineScanner::Instruction i1 = regexWrapper.searchInstruction(text), i2 = scanner.searchInstruction(text);
+    compare("searchInstruction", text, describe(i1.type, i1.param1, i1.param2, i1.param3), describe(i2.type, i2.param1, i2.param2, i2.param3));
+
+    LineScanner::Jump j1 = regexWrapper.searchJump(text), j2 = scanner.searchJump(text);
+    compare("searchJump", text, describe(j1.type, j1.param1, j1.param2), describe(j2.type, j2.param1, j2.param2));
+
+    LineScanner::LoadStore l1 = regexWrapper.searchLoadStore(text), l2 = scanner.searchLoadStore(text);
+    compare("searchLoadStore", text, describe(l1.type, l1.param1, l1.param2), describe(l2.type, l2.param1, l2.param2));
+
+    LineScanner::Literal n1 = regexWrapper.searchLiteral(text), n2 = scanner.searchLiteral(text);
+    compare("searchLiteral", text, describe(n1.type, n1.param1), describe(n2.type, n2.param1));
+
+    compare("isSymbol", text, to_string(regexWrapper.isSymbol(text)), to_string(scanner.isSymbol(text)));
+}
+
+void checkNormalization(const string &line)
+{
+    string expected = regexWrapper.removeBlankLinesComments(line);
+    string normalized = line;
+    scanner.normalizeLine(normalized);
+    compare("normalizeLine", line, expected, normalized);
+
+    string buffer = "stale";
+    compare("normalizeLine(view)", line, expected, string(scanner.normalizeLine(string_view(line), buffer)));
+}
+
+void checkLine(const string &line)
+{
+    // the whole line and every piece the parser may hand over later on
+    checkText(line);
+
+    LineScanner::Directive directive = regexWrapper.searchLine(line);
+    if (directive.type == LineScanner::LABEL_WITH_INSTRUCTION)
+    {
+        checkLine(string(directive.param2));
+    }
+
+    LineScanner::Instruction instruction = regexWrapper.searchInstruction(line);
+    checkText(string(instruction.param2));
+    checkText(string(instruction.param3));
+
+    size_t start = 0;
+    while (start <= line.size())
+    {
+        size_t end = line.find_first_of(" ,", start);
+        end = end == string::npos ? line.size() : end;
+        checkText(line.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+int checkFile(const string &path)
+{
+    FileReader reader(path);
+    if (!reader.isFileOpened())
+    {
+        cout << "Cannot open the file with path: " << path << endl;
+        return 1;
+    }
+
+    string line = reader.getNextLine();
+    while (!reader.isEndOfFile())
+    {
+        checkNormalization(line);
+        checkLine(regexWrapper.removeBlankLinesComments(line));
+        line = reader.getNextLine();
+    }
+    return 0;
+}
+
+void checkEdgeCases()
+{
+    const vector<string> lines = {
+        "", " ", "label:", "label:halt", "label:.word 1", "1label:", "la bel:", "label:\r", "label:x\ry",
+        ".section", ".section ", ".section text", ".section 1text", ".section text data", ".sections text",
+        ".equ a,1", ".equ a,-1", ".equ a,0x1F", ".equ a,0x1f", ".equ a,", ".equ ,1", ".equ a,b", ".equ a,1,2",
+        ".skip 8", ".skip -8", ".skip 0x", ".skip 0xA", ".skip a", ".end", ".end ", ".end\r", ".endx",
+        ".global a", ".global a,b", ".global a,b,c", ".global a,", ".global ,a", ".global a,1", ".global",
+        ".extern a,b_1,c2", ".extern 1", ".word 1", ".word a,1,0x2,-3", ".word a,", ".word ,a", ".word 0x",
+        "halt", "iret", "ret", "halt ", "halts", "push r0", "pop psw", "int r7", "not r8", "push r0,r1",
+        "call a", "jmp *r1", "jeq %a", "jne *[r2]", "jgt *[psw + 0x10]", "jmp ", "jmp a\r", "jmpx a",
+        "ldr r0,$1", "str psw,%a", "ldr r1,", "ldr r8,a", "ldr r1 ,a", "ldr r1,[r2 + a]", "ldr r1,[r2+a]",
+        "add r1,r2", "or psw,r0", "xor r1,r2,r3", "shl r1", "test r0,psw", "cmp r1,r8",
+        "$a", "$1", "$-1", "$0x1", "$", "%a", "%1", "%", "r0", "r7", "r8", "psw", "pswx", "[r1]", "[psw]",
+        "[r1 + a]", "[r1 + 1]", "[r1 + 0xF]", "[r1 + ]", "[r1 +a]", "[r9]", "[]", "[", "]", "*a", "*1",
+        "*0xFF", "*r1", "*psw", "*[r1]", "*[r1 + b]", "*[r1 + -2]", "*", "*%a", "0x", "0xG", "-", "-0",
+        "a_b", "_a", "a-b", "0x1F", "0x1f", "-12", "12a", "\xc3\xa9", "a\xc3\xa9"};
+
+    for (const string &line : lines)
+    {
+        checkLine(line);
+    }
+
+    const vector<string> rawLines = {
+        "", " ", "  ", "\t", "\t\t", " \t ", "a", " a ", "\ta\t", "ab", " ab ", "  ab  ", "# comment",
+        "   # comment", "ldr r1, $1 # load", "ldr  r1 ,  $1", "ldr\tr1,\t$1", "label :  halt", "a , b , c",
+        "a ,, b", ", ,", ": :", ", :", ": ,", " , ", "a\r", " a\r ", "a\rb", " a \r b ", "a # x\r y",
+        "#\r", "a#b#c", ".word 1 , 2 ,3", "\t.section\ttext\t", "x:\t.word\t1,\t2"};
+
+    for (const string &line : rawLines)
+    {
+        checkNormalization(line);
+    }
+}
+
+void checkRandomLines()
+{
+    const vector<string> pieces = {
+        "ldr", "str", "jmp", "call", "push", "halt", "add", "or", ".word", ".global", ".extern", ".equ",
+        ".skip", ".section", ".end", "r1", "r8", "psw", "a", "b_2", "1", "-4", "0x1F", "0x", " ", " ",
+        ",", ":", "$", "%", "*", "[", "]", " + ", "\r", "\t", "_"};
+
+    mt19937 generator(20211018);
+    for (int i = 0; i < 30000; i++)
+    {
+        string line;
+        int count = 1 + generator() % 7;
+        for (int j = 0; j < count; j++)
+        {
+            line += pieces[generator() % pieces.size()];
+        }
+        checkText(line);
+    }
+
+    const string characters = "  \t\t,,::#ab.\r";
+    for (int i = 0; i < 30000; i++)
+    {
+        string line;
+        int count = generator() % 12;
+        for (int j = 0; j < count; j++)
+        {
+            line += characters[generator() % characters.size()];
+        }
+        checkNormalization(line);
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    int failedFiles = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        failedFiles += checkFile(argv[i]);
+    }
+    checkEdgeCases();
+    checkRandomLines();
+
+    cout << "LineScanner: " << checks << " checks, " << mismatches << " mismatches" << endl;
+    return mismatches == 0 && failedFiles == 0 ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+# file directives.s
+# errors of every kind in one file, each is reported with its line
+halt
+.word 1
+.skip 2
+lab:
+.section text
+  foo r1
+  jmp [r1]
+  ldr r1, *r2
+  ldr r9, r1
+x:
+  halt
+x:
+  halt
+.extern x
+.equ x, 5
+.extern y
+y:
+  halt
+.end
@@ -0,0 +1,12 @@
+# file literals.s
+# literals that do not fit and a negative .skip are reported, the lines after them still are assembled
+.equ ok, -1
+.equ big, 70000
+.equ huge, 99999999999
+.section data
+    .word 65535, -32768
+    .word 65536
+    .word -32769
+    .skip -2
+    .word ok
+.end
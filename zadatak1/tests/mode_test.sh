@@ -0,0 +1,56 @@
+#!/bin/bash
+
+# Every source is assembled in every mode and format; the output has to be the same
+# as the one of the two pass assembly on one thread. The sources in tests/modes also
+# have an expected text output and the ones in tests/errors their expected messages.
+
+WORK_DIR=$(mktemp -d)
+trap "rm -rf $WORK_DIR" EXIT
+MODES=("--one-pass -j 1" "-j 4" "--one-pass -j 4")
+failed=0
+
+for source in tests/*.s tests/modes/*.s; do
+    for format in text binary; do
+        ./asembler -j 1 --format=$format -o $WORK_DIR/reference $source > /dev/null || { echo "$source: assembly failed"; failed=1; }
+        for mode in "${MODES[@]}"; do
+            ./asembler $mode --format=$format -o $WORK_DIR/output $source > /dev/null
+            if ! cmp -s $WORK_DIR/reference $WORK_DIR/output; then
+                echo "$source: $format output of $mode differs"
+                failed=1
+            fi
+        done
+    done
+done
+
+for source in tests/modes/*.s; do
+    ./asembler -o $WORK_DIR/output $source > /dev/null
+    if ! cmp -s ${source%.s}.expected $WORK_DIR/output; then
+        echo "$source: text output differs from ${source%.s}.expected"
+        failed=1
+    fi
+done
+
+# the 0x7000 bytes of .skip in skip.s take no room in the binary object
+./asembler --format=binary -o $WORK_DIR/skip.o tests/modes/skip.s > /dev/null
+if [ $(wc -c < $WORK_DIR/skip.o) -ge 1024 ]; then
+    echo "tests/modes/skip.s: .skip is stored in the binary object"
+    failed=1
+fi
+
+for source in tests/errors/*.s; do
+    for mode in "-j 1" "${MODES[@]}"; do
+        rm -f $WORK_DIR/output
+        ./asembler $mode -o $WORK_DIR/output $source > $WORK_DIR/messages
+        status=$?
+        if [ $status -ne 1 ] || [ -e $WORK_DIR/output ] || ! cmp -s ${source%.s}.expected $WORK_DIR/messages; then
+            echo "$source: messages of $mode differ from ${source%.s}.expected (exit $status)"
+            failed=1
+        fi
+    done
+done
+
+if [ $failed -ne 0 ]; then
+    echo "Modes: FAILED"
+    exit 1
+fi
+echo "Modes: all outputs match"
@@ -0,0 +1,17 @@
+# file reopen.s
+# a repeated .section continues the section it names
+.global start
+.section code
+start:
+    ldr r0, $1
+    jmp next
+.section data
+first:
+    .word start, 0x1234
+.section code
+next:
+    ldr r1, first
+    jmp %start
+.section data
+    .word next
+.end
@@ -0,0 +1,12 @@
+# file skip.s
+# .skip is kept as a zero fill span, in the text and in the binary object
+.section table
+    .word entry
+    .skip 0x7000
+    .word entry
+    .skip 3
+.section code
+entry:
+    .skip 0x10
+    halt
+.end
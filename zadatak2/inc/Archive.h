@@ -0,0 +1,37 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ArchiveFormat.h"
+#include "../../zadatak1/inc/FileReader.h"
+
+using namespace std;
+
+// Read only view of an archive file. The tables are checked once when the file is read,
+// members stay in the mapped file until one is asked for.
+class Archive
+{
+private:
+    FileReader *reader;
+    string_view contents;
+    const ArchiveHeader *header;
+    const ArchiveMember *members;
+    const ArchiveSymbol *symbols;
+
+    string_view getString(uint32_t offset);
+
+public:
+    Archive();
+    ~Archive();
+    bool read(const string &filePath);
+    bool parse(string_view bytes);
+    int findMember(string_view symbol);
+    int getMemberCount();
+    string_view getMemberName(int member);
+    string_view getMemberBytes(int member);
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef ARCHIVE_BUILDER_H
+#define ARCHIVE_BUILDER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ArchiveFormat.h"
+#include "../../zadatak1/inc/ObjectFile.h"
+
+using namespace std;
+
+// Collects objects for a new archive and builds its symbol index. When two members
+// define the same global, the index keeps the first one.
+class ArchiveBuilder
+{
+private:
+    vector<ArchiveMember> members;
+    vector<ArchiveSymbol> symbols;
+    string stringTable;
+    string data;
+
+    uint32_t addString(string_view name);
+
+public:
+    ArchiveBuilder();
+    ~ArchiveBuilder();
+    void addMember(string_view name, string_view bytes, const ObjectFile &object);
+    void serialize(string &bytes);
+    bool write(const string &filePath);
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef ARCHIVE_FORMAT_H
+#define ARCHIVE_FORMAT_H
+
+#include <cstdint>
+
+// Library of binary objects. Little endian and naturally aligned like the object file.
+//
+//   ArchiveHeader
+//   ArchiveMember[memberCount]
+//   ArchiveSymbol[symbolCount]     sorted by name
+//   string table                   zero terminated names, referenced by offset
+//   member data                    every member is a whole object file, 4 byte aligned
+//
+// The symbol table is the index: every global symbol with the member that defines it,
+// so a linker finds the members it needs without looking into the others.
+
+const uint32_t ARCHIVE_MAGIC = 0x43524148; // "HARC"
+const uint16_t ARCHIVE_VERSION = 1;
+
+struct ArchiveHeader
+{
+    uint32_t magic;
+    uint16_t version, reserved;
+    uint32_t memberCount, memberTableOffset;
+    uint32_t symbolCount, symbolTableOffset;
+    uint32_t stringTableSize, stringTableOffset;
+    uint32_t dataSize, dataOffset;
+};
+
+struct ArchiveMember
+{
+    uint32_t name;
+    uint32_t dataOffset;
+    uint32_t size;
+};
+
+struct ArchiveSymbol
+{
+    uint32_t name;
+    uint32_t member;
+};
+
+static_assert(sizeof(ArchiveHeader) == 40, "archive header layout");
+static_assert(sizeof(ArchiveMember) == 12, "archive member layout");
+static_assert(sizeof(ArchiveSymbol) == 8, "archive symbol layout");
+
+#endif
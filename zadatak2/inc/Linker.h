@@ -0,0 +1,124 @@
+#ifndef LINKER_H
+#define LINKER_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../../zadatak1/inc/ObjectFile.h"
+#include "../../zadatak1/inc/WorkerPool.h"
+#include "Archive.h"
+
+using namespace std;
+
+// Links binary objects of the assembler. Sections with the same name are concatenated in
+// input order, globals are resolved through one hash table and the relocations are either
+// applied (memory image) or carried over to one combined relocatable object. Archive
+// members are linked only when they define a symbol that is still undefined. With garbage
+// collection a memory image only gets the sections that the interrupt table or the entry
+// symbol reach through relocations.
+class Linker
+{
+public:
+    enum OutputFormat
+    {
+        HEX,
+        RELOCATABLE
+    };
+
+private:
+    struct InputFile
+    {
+        string path;
+        ObjectFile object;
+        // output section and offset in it of every input section, -1 for the undefined and absolute ones
+        vector<int> outputSection;
+        vector<uint32_t> sectionOffset;
+        // sections that garbage collection keeps, empty when it is off
+        vector<bool> live;
+        // final address of every symbol, set only for a memory image
+        vector<int> symbolAddress;
+        vector<char> symbolDefined;
+        InputFile(const string &p) : path(p) {}
+    };
+
+    struct OutputSection
+    {
+        string_view name;
+        uint32_t address, size;
+        bool placed;
+        // input sections in link order, as (file, section) pairs
+        vector<pair<int, int>> pieces;
+        OutputSection(string_view n) : name(n), address(0), size(0), placed(false) {}
+    };
+
+    // where a global symbol is defined
+    struct GlobalSymbol
+    {
+        int file, symbol;
+        GlobalSymbol(int f, int s) : file(f), symbol(s) {}
+    };
+
+    // relocations of one input section, applied by one task
+    struct RelocationTask
+    {
+        int outputSection, file, section;
+        RelocationTask(int o, int f, int s) : outputSection(o), file(f), section(s) {}
+    };
+
+    vector<string> inputPaths;
+    vector<InputFile *> inputFiles;
+    vector<Archive *> archives;
+    vector<string> archivePaths;
+    vector<pair<string, uint32_t>> placements;
+    string outputFilePath;
+    OutputFormat outputFormat;
+    WorkerPool *workerPool;
+    bool garbageCollection;
+    string entrySymbol;
+    unordered_set<string_view> droppedSections;
+
+    vector<OutputSection> outputSections;
+    unordered_map<string_view, int> outputSectionIndex;
+    unordered_map<string_view, GlobalSymbol> globalSymbols;
+    ObjectFile output;
+    vector<string> errors;
+
+    bool readInputs();
+    void collectSections();
+    void resolveSymbols();
+    void addGlobalSymbols(int f);
+    void addUndefinedSymbols(int f, vector<string_view> &undefined, unordered_set<string_view> &requested);
+    void loadArchiveMembers();
+    void collectGarbage();
+    void markLive(int f, int section, vector<pair<int, int>> &reached);
+    void placeSections();
+    void mergeSections();
+    bool symbolAddress(int file, int symbol, int &address);
+    char *fieldAddress(int outputSectionIndex, uint32_t offset);
+    void resolveAddresses();
+    void applyRelocations();
+    void applySectionRelocations(const RelocationTask &task, vector<string> &taskErrors);
+    void runTasks(int count, const function<void(int)> &task);
+    void buildRelocatable();
+    bool writeHex();
+    void addError(const string &message);
+    void printErrors(ostream &messages);
+
+public:
+    Linker();
+    ~Linker();
+    void addInputFile(const string &filePath);
+    void addPlacement(const string &sectionName, uint32_t address);
+    void setOutputFile(const string &filePath);
+    void setOutputFormat(OutputFormat format);
+    void setGarbageCollection(bool enabled);
+    void setEntrySymbol(const string &symbol);
+    void setWorkerPool(WorkerPool *pool);
+    bool link(ostream &messages = cout);
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include <cstring>
+#include <algorithm>
+
+#include "../inc/Archive.h"
+
+using namespace std;
+
+Archive::Archive() : reader(nullptr), header(nullptr), members(nullptr), symbols(nullptr)
+{
+}
+
+Archive::~Archive()
+{
+    delete reader;
+}
+
+bool Archive::read(const string &filePath)
+{
+    delete reader;
+    reader = new FileReader(filePath);
+    return reader->isFileOpened() && parse(reader->getContents());
+}
+
+bool Archive::parse(string_view bytes)
+{
+    // the tables are used in place, so they have to be inside the bytes and aligned
+    header = nullptr;
+    if (bytes.size() < sizeof(ArchiveHeader) || (uintptr_t)bytes.data() % 4 != 0)
+    {
+        return false;
+    }
+    const ArchiveHeader *candidate = (const ArchiveHeader *)bytes.data();
+    if (candidate->magic != ARCHIVE_MAGIC || candidate->version != ARCHIVE_VERSION)
+    {
+        return false;
+    }
+    if (candidate->memberTableOffset % 4 != 0 || candidate->memberTableOffset > bytes.size() ||
+        candidate->memberCount > (bytes.size() - candidate->memberTableOffset) / sizeof(ArchiveMember) ||
+        candidate->symbolTableOffset % 4 != 0 || candidate->symbolTableOffset > bytes.size() ||
+        candidate->symbolCount > (bytes.size() - candidate->symbolTableOffset) / sizeof(ArchiveSymbol) ||
+        candidate->stringTableOffset > bytes.size() || candidate->stringTableSize > bytes.size() - candidate->stringTableOffset)
+    {
+        return false;
+    }
+
+    const ArchiveMember *memberTable = (const ArchiveMember *)(bytes.data() + candidate->memberTableOffset);
+    for (uint32_t i = 0; i < candidate->memberCount; i++)
+    {
+        if (memberTable[i].dataOffset > bytes.size() || memberTable[i].size > bytes.size() - memberTable[i].dataOffset)
+        {
+            return false;
+        }
+    }
+    const ArchiveSymbol *symbolTable = (const ArchiveSymbol *)(bytes.data() + candidate->symbolTableOffset);
+    for (uint32_t i = 0; i < candidate->symbolCount; i++)
+    {
+        if (symbolTable[i].member >= candidate->memberCount)
+        {
+            return false;
+        }
+    }
+
+    contents = bytes;
+    header = candidate;
+    members = memberTable;
+    symbols = symbolTable;
+    return true;
+}
+
+string_view Archive::getString(uint32_t offset)
+{
+    if (offset >= header->stringTableSize)
+    {
+        return string_view();
+    }
+    const char *start = contents.data() + header->stringTableOffset + offset;
+    const char *end = (const char *)memchr(start, '\0', header->stringTableSize - offset);
+    return end == nullptr ? string_view() : string_view(start, end - start);
+}
+
+int Archive::findMember(string_view symbol)
+{
+    // the index is sorted by name, so a lookup is a binary search in the mapped table
+    if (header == nullptr)
+    {
+        return -1;
+    }
+    const ArchiveSymbol *last = symbols + header->symbolCount;
+    const ArchiveSymbol *found = lower_bound(symbols, last, symbol, [this](const ArchiveSymbol &entry, string_view name)
+    {
+        return getString(entry.name) < name;
+    });
+    return found != last && getString(found->name) == symbol ? (int)found->member : -1;
+}
+
+int Archive::getMemberCount()
+{
+    return header == nullptr ? 0 : header->memberCount;
+}
+
+string_view Archive::getMemberName(int member)
+{
+    return getString(members[member].name);
+}
+
+string_view Archive::getMemberBytes(int member)
+{
+    return contents.substr(members[member].dataOffset, members[member].size);
+}
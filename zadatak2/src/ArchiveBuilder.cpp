@@ -0,0 +1,100 @@
+#include <cstring>
+#include <algorithm>
+
+#include "../inc/ArchiveBuilder.h"
+#include "../../zadatak1/inc/FileWriter.h"
+
+using namespace std;
+
+ArchiveBuilder::ArchiveBuilder()
+{
+}
+
+ArchiveBuilder::~ArchiveBuilder()
+{
+}
+
+uint32_t ArchiveBuilder::addString(string_view name)
+{
+    uint32_t offset = stringTable.size();
+    stringTable.append(name.data(), name.size());
+    stringTable += '\0';
+    return offset;
+}
+
+void ArchiveBuilder::addMember(string_view name, string_view bytes, const ObjectFile &object)
+{
+    ArchiveMember member;
+    member.name = addString(name);
+    member.dataOffset = data.size();
+    member.size = bytes.size();
+    members.push_back(member);
+
+    data.append(bytes.data(), bytes.size());
+    data.append((4 - data.size() % 4) % 4, '\0');
+
+    for (vector<ObjectSymbol>::const_iterator symbol = object.symbols.begin(); symbol != object.symbols.end(); symbol++)
+    {
+        if (symbol->type == OBJECT_SYMBOL_GLOBAL)
+        {
+            ArchiveSymbol entry;
+            entry.name = addString(object.getString(symbol->name));
+            entry.member = members.size() - 1;
+            symbols.push_back(entry);
+        }
+    }
+}
+
+void ArchiveBuilder::serialize(string &bytes)
+{
+    // sorted by name for the binary search of the linker, the first definition stays
+    const string &strings = stringTable;
+    stable_sort(symbols.begin(), symbols.end(), [&strings](const ArchiveSymbol &first, const ArchiveSymbol &second)
+    {
+        return strcmp(strings.c_str() + first.name, strings.c_str() + second.name) < 0;
+    });
+    symbols.erase(unique(symbols.begin(), symbols.end(), [&strings](const ArchiveSymbol &first, const ArchiveSymbol &second)
+    {
+        return strcmp(strings.c_str() + first.name, strings.c_str() + second.name) == 0;
+    }), symbols.end());
+
+    uint32_t stringTableSize = (stringTable.size() + 3) & ~3u;
+
+    ArchiveHeader header = {};
+    header.magic = ARCHIVE_MAGIC;
+    header.version = ARCHIVE_VERSION;
+    header.memberCount = members.size();
+    header.memberTableOffset = sizeof(ArchiveHeader);
+    header.symbolCount = symbols.size();
+    header.symbolTableOffset = header.memberTableOffset + members.size() * sizeof(ArchiveMember);
+    header.stringTableSize = stringTableSize;
+    header.stringTableOffset = header.symbolTableOffset + symbols.size() * sizeof(ArchiveSymbol);
+    header.dataSize = data.size();
+    header.dataOffset = header.stringTableOffset + stringTableSize;
+
+    bytes.clear();
+    bytes.reserve(header.dataOffset + data.size());
+    bytes.append((const char *)&header, sizeof(header));
+    for (vector<ArchiveMember>::iterator member = members.begin(); member != members.end(); member++)
+    {
+        ArchiveMember entry = *member;
+        entry.dataOffset += header.dataOffset;
+        bytes.append((const char *)&entry, sizeof(entry));
+    }
+    bytes.append((const char *)symbols.data(), symbols.size() * sizeof(ArchiveSymbol));
+    bytes.append(stringTable);
+    bytes.append(stringTableSize - stringTable.size(), '\0');
+    bytes.append(data);
+}
+
+bool ArchiveBuilder::write(const string &filePath)
+{
+    string bytes;
+    serialize(bytes);
+
+    FileWriter *fw = new FileWriter(filePath);
+    bool opened = fw->isFileOpened();
+    fw->writeBytes(bytes.data(), bytes.size());
+    delete fw;
+    return opened;
+}
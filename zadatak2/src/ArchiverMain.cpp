@@ -0,0 +1,62 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../inc/ArchiveBuilder.h"
+#include "../../zadatak1/inc/FileReader.h"
+
+using namespace std;
+
+// Bundles objects of the assembler into one library with a global symbol index.
+// Usage: archiver -o <library> <object>...
+int main(int argc, const char *argv[])
+{
+    string outputFile;
+    vector<string> inputFiles;
+    for (int i = 1; i < argc; i++)
+    {
+        string argument = argv[i];
+        if (argument == "-o" && i + 1 < argc)
+        {
+            outputFile = argv[++i];
+        }
+        else
+        {
+            inputFiles.push_back(argument);
+        }
+    }
+
+    if (outputFile == "" || inputFiles.empty())
+    {
+        cout << "Usage: archiver -o <library> <object>..." << endl;
+        return -1;
+    }
+
+    ArchiveBuilder *builder = new ArchiveBuilder();
+    bool hasError = false;
+    for (vector<string>::iterator input = inputFiles.begin(); input != inputFiles.end(); input++)
+    {
+        FileReader *fr = new FileReader(*input);
+        ObjectFile object;
+        string_view bytes = fr->getContents();
+        if (!fr->isFileOpened() || !object.parse(bytes))
+        {
+            cout << "Cannot read object file: " << *input << endl;
+            hasError = true;
+        }
+        else
+        {
+            size_t slash = input->find_last_of('/');
+            builder->addMember(slash == string::npos ? *input : input->substr(slash + 1), bytes, object);
+        }
+        delete fr;
+    }
+
+    if (!hasError && !builder->write(outputFile))
+    {
+        cout << "Cannot open the output file with path: " << outputFile << endl;
+        hasError = true;
+    }
+    delete builder;
+    return hasError ? 1 : 0;
+}
@@ -0,0 +1,842 @@
+#include <algorithm>
+#include <cstdio>
+
+#include "../inc/Linker.h"
+#include "../../zadatak1/inc/FileWriter.h"
+
+using namespace std;
+
+const uint32_t MEMORY_SIZE = 0x10000;
+const string_view INTERRUPT_TABLE_SECTION = "ivt";
+
+Linker::Linker() : outputFormat(HEX), workerPool(nullptr), garbageCollection(false)
+{
+}
+
+Linker::~Linker()
+{
+    for (vector<InputFile *>::iterator file = inputFiles.begin(); file != inputFiles.end(); file++)
+    {
+        delete *file;
+    }
+    for (vector<Archive *>::iterator archive = archives.begin(); archive != archives.end(); archive++)
+    {
+        delete *archive;
+    }
+}
+
+void Linker::addInputFile(const string &filePath)
+{
+    inputPaths.push_back(filePath);
+}
+
+void Linker::addPlacement(const string &sectionName, uint32_t address)
+{
+    placements.push_back(make_pair(sectionName, address));
+}
+
+void Linker::setOutputFile(const string &filePath)
+{
+    outputFilePath = filePath;
+}
+
+void Linker::setOutputFormat(OutputFormat format)
+{
+    outputFormat = format;
+}
+
+void Linker::setGarbageCollection(bool enabled)
+{
+    garbageCollection = enabled;
+}
+
+void Linker::setEntrySymbol(const string &symbol)
+{
+    entrySymbol = symbol;
+}
+
+void Linker::setWorkerPool(WorkerPool *pool)
+{
+    // symbol addresses and relocations are split over the pool, without one they run here
+    workerPool = pool;
+}
+
+void Linker::runTasks(int count, const function<void(int)> &task)
+{
+    if (workerPool)
+    {
+        workerPool->forEach(count, task);
+        return;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        task(i);
+    }
+}
+
+bool Linker::link(ostream &messages)
+{
+    if (!readInputs())
+    {
+        printErrors(messages);
+        return false;
+    }
+
+    resolveSymbols();
+    loadArchiveMembers();
+    if (garbageCollection && outputFormat == HEX)
+    {
+        collectGarbage();
+    }
+    collectSections();
+    if (outputFormat == HEX)
+    {
+        placeSections();
+    }
+    if (!errors.empty())
+    {
+        printErrors(messages);
+        return false;
+    }
+
+    mergeSections();
+    if (outputFormat == HEX)
+    {
+        resolveAddresses();
+        applyRelocations();
+    }
+    else
+    {
+        buildRelocatable();
+    }
+    if (!errors.empty())
+    {
+        printErrors(messages);
+        return false;
+    }
+
+    bool written = outputFormat == HEX ? writeHex() : output.write(outputFilePath);
+    if (!written)
+    {
+        messages << "Cannot open the output file with path: " + outputFilePath << endl;
+    }
+    return written;
+}
+
+bool Linker::readInputs()
+{
+    // objects are always linked, archives only give the members that are needed
+    for (vector<string>::iterator path = inputPaths.begin(); path != inputPaths.end(); path++)
+    {
+        Archive *archive = new Archive();
+        if (archive->read(*path))
+        {
+            archives.push_back(archive);
+            archivePaths.push_back(*path);
+            continue;
+        }
+        delete archive;
+
+        InputFile *file = new InputFile(*path);
+        inputFiles.push_back(file);
+        if (!file->object.read(*path))
+        {
+            addError("Cannot read object file: " + *path);
+        }
+    }
+    return errors.empty();
+}
+
+void Linker::collectSections()
+{
+    // output sections keep the order in which their names first appear
+    for (int f = 0; f < (int)inputFiles.size(); f++)
+    {
+        InputFile *file = inputFiles[f];
+        const vector<ObjectSection> &sections = file->object.sections;
+        file->outputSection.assign(sections.size(), -1);
+        file->sectionOffset.assign(sections.size(), 0);
+
+        for (int s = 0; s < (int)sections.size(); s++)
+        {
+            if (s == OBJECT_UNDEFINED_SECTION || s == OBJECT_ABSOLUTE_SECTION || (!file->live.empty() && !file->live[s]))
+            {
+                continue;
+            }
+
+            string_view name = file->object.getString(sections[s].name);
+            unordered_map<string_view, int>::iterator found = outputSectionIndex.find(name);
+            int index;
+            if (found == outputSectionIndex.end())
+            {
+                index = outputSections.size();
+                outputSections.push_back(OutputSection(name));
+                outputSectionIndex.insert(make_pair(name, index));
+            }
+            else
+            {
+                index = found->second;
+            }
+
+            OutputSection &section = outputSections[index];
+            file->outputSection[s] = index;
+            file->sectionOffset[s] = section.size;
+            section.pieces.push_back(make_pair(f, s));
+            section.size += sections[s].size;
+        }
+    }
+}
+
+void Linker::resolveSymbols()
+{
+    // one table for the globals of every file, sized up front so it never rehashes
+    size_t symbolCount = 0;
+    for (vector<InputFile *>::iterator file = inputFiles.begin(); file != inputFiles.end(); file++)
+    {
+        symbolCount += (*file)->object.symbols.size();
+    }
+    globalSymbols.reserve(symbolCount);
+
+    for (int f = 0; f < (int)inputFiles.size(); f++)
+    {
+        addGlobalSymbols(f);
+    }
+}
+
+void Linker::addGlobalSymbols(int f)
+{
+    const ObjectFile &object = inputFiles[f]->object;
+    for (int s = 0; s < (int)object.symbols.size(); s++)
+    {
+        if (object.symbols[s].type != OBJECT_SYMBOL_GLOBAL)
+        {
+            continue;
+        }
+
+        string_view name = object.getString(object.symbols[s].name);
+        pair<unordered_map<string_view, GlobalSymbol>::iterator, bool> inserted = globalSymbols.insert(make_pair(name, GlobalSymbol(f, s)));
+        if (!inserted.second)
+        {
+            addError("Symbol " + string(name) + " is defined in " + inputFiles[inserted.first->second.file]->path + " and " + inputFiles[f]->path);
+        }
+    }
+}
+
+void Linker::addUndefinedSymbols(int f, vector<string_view> &undefined, unordered_set<string_view> &requested)
+{
+    const ObjectFile &object = inputFiles[f]->object;
+    for (vector<ObjectSymbol>::const_iterator symbol = object.symbols.begin(); symbol != object.symbols.end(); symbol++)
+    {
+        if (symbol->type == OBJECT_SYMBOL_EXTERN || symbol->type == OBJECT_SYMBOL_UNDEFINED)
+        {
+            string_view name = object.getString(symbol->name);
+            if (requested.insert(name).second)
+            {
+                undefined.push_back(name);
+            }
+        }
+    }
+}
+
+void Linker::loadArchiveMembers()
+{
+    // every symbol that is still undefined is looked up in the archive indexes, in the
+    // order the symbols were found; a loaded member adds its own undefined symbols
+    if (archives.empty())
+    {
+        return;
+    }
+
+    vector<string_view> undefined;
+    unordered_set<string_view> requested;
+    vector<vector<bool>> loaded(archives.size());
+    for (int a = 0; a < (int)archives.size(); a++)
+    {
+        loaded[a].assign(archives[a]->getMemberCount(), false);
+    }
+    for (int f = 0; f < (int)inputFiles.size(); f++)
+    {
+        addUndefinedSymbols(f, undefined, requested);
+    }
+
+    for (size_t i = 0; i < undefined.size(); i++)
+    {
+        if (globalSymbols.count(undefined[i]) > 0)
+        {
+            continue;
+        }
+
+        for (int a = 0; a < (int)archives.size(); a++)
+        {
+            int member = archives[a]->findMember(undefined[i]);
+            if (member < 0 || loaded[a][member])
+            {
+                continue;
+            }
+
+            loaded[a][member] = true;
+            InputFile *file = new InputFile(archivePaths[a] + "(" + string(archives[a]->getMemberName(member)) + ")");
+            if (!file->object.parse(archives[a]->getMemberBytes(member)))
+            {
+                addError("Cannot read object file: " + file->path);
+                delete file;
+                break;
+            }
+            inputFiles.push_back(file);
+            addGlobalSymbols(inputFiles.size() - 1);
+            addUndefinedSymbols(inputFiles.size() - 1, undefined, requested);
+            break;
+        }
+    }
+}
+
+void Linker::collectGarbage()
+{
+    // input sections are the nodes and relocations the edges; the interrupt table and the
+    // section of the entry symbol are the roots, sections that are not reached are dropped
+    vector<pair<int, int>> reached;
+    for (int f = 0; f < (int)inputFiles.size(); f++)
+    {
+        inputFiles[f]->live.assign(inputFiles[f]->object.sections.size(), false);
+    }
+
+    for (int f = 0; f < (int)inputFiles.size(); f++)
+    {
+        const ObjectFile &object = inputFiles[f]->object;
+        for (int s = 0; s < (int)object.sections.size(); s++)
+        {
+            if (object.getString(object.sections[s].name) == INTERRUPT_TABLE_SECTION)
+            {
+                markLive(f, s, reached);
+            }
+        }
+    }
+    if (entrySymbol != "")
+    {
+        unordered_map<string_view, GlobalSymbol>::iterator entry = globalSymbols.find(entrySymbol);
+        if (entry == globalSymbols.end())
+        {
+            addError("Entry symbol " + entrySymbol + " is not defined");
+        }
+        else if (inputFiles[entry->second.file]->object.symbols[entry->second.symbol].section == OBJECT_ABSOLUTE_SECTION)
+        {
+            addError("Entry symbol " + entrySymbol + " is not in a section");
+        }
+        else
+        {
+            markLive(entry->second.file, inputFiles[entry->second.file]->object.symbols[entry->second.symbol].section, reached);
+        }
+    }
+
+    if (reached.empty() && errors.empty())
+    {
+        addError("Nothing to keep with --gc-sections: there is no ivt section and no --entry symbol");
+        return;
+    }
+
+    for (size_t i = 0; i < reached.size(); i++)
+    {
+        int f = reached[i].first;
+        const ObjectFile &object = inputFiles[f]->object;
+        const ObjectSection &section = object.sections[reached[i].second];
+        for (uint32_t r = section.firstRelocation; r < section.firstRelocation + section.relocationCount; r++)
+        {
+            int symbol = object.relocations[r].symbol;
+            if (symbol == OBJECT_NO_SYMBOL)
+            {
+                continue;
+            }
+
+            const ObjectSymbol &entry = object.symbols[symbol];
+            if (entry.type == OBJECT_SYMBOL_EXTERN || entry.type == OBJECT_SYMBOL_UNDEFINED)
+            {
+                unordered_map<string_view, GlobalSymbol>::iterator definition = globalSymbols.find(object.getString(entry.name));
+                if (definition != globalSymbols.end())
+                {
+                    markLive(definition->second.file, inputFiles[definition->second.file]->object.symbols[definition->second.symbol].section, reached);
+                }
+                continue;
+            }
+            markLive(f, entry.section, reached);
+        }
+    }
+
+    for (int f = 0; f < (int)inputFiles.size(); f++)
+    {
+        const ObjectFile &object = inputFiles[f]->object;
+        for (int s = 0; s < (int)object.sections.size(); s++)
+        {
+            if (!inputFiles[f]->live[s])
+            {
+                droppedSections.insert(object.getString(object.sections[s].name));
+            }
+        }
+    }
+}
+
+void Linker::markLive(int f, int section, vector<pair<int, int>> &reached)
+{
+    if (section == (int)OBJECT_UNDEFINED_SECTION || section == (int)OBJECT_ABSOLUTE_SECTION || inputFiles[f]->live[section])
+    {
+        return;
+    }
+    inputFiles[f]->live[section] = true;
+    reached.push_back(make_pair(f, section));
+}
+
+void Linker::placeSections()
+{
+    for (vector<pair<string, uint32_t>>::iterator placement = placements.begin(); placement != placements.end(); placement++)
+    {
+        unordered_map<string_view, int>::iterator found = outputSectionIndex.find(placement->first);
+        if (found == outputSectionIndex.end())
+        {
+            if (droppedSections.count(placement->first) > 0)
+            {
+                addError("Placed section " + placement->first + " was removed by --gc-sections");
+            }
+            else
+            {
+                addError("Placed section " + placement->first + " does not exist");
+            }
+            continue;
+        }
+        outputSections[found->second].address = placement->second;
+        outputSections[found->second].placed = true;
+    }
+
+    // sections without -place go behind the highest placed one, in output order
+    uint32_t nextAddress = 0;
+    vector<OutputSection *> ordered;
+    for (vector<OutputSection>::iterator section = outputSections.begin(); section != outputSections.end(); section++)
+    {
+        if (section->placed)
+        {
+            nextAddress = max(nextAddress, section->address + section->size);
+        }
+    }
+    for (vector<OutputSection>::iterator section = outputSections.begin(); section != outputSections.end(); section++)
+    {
+        if (!section->placed)
+        {
+            section->address = nextAddress;
+            nextAddress += section->size;
+        }
+        ordered.push_back(&*section);
+    }
+
+    stable_sort(ordered.begin(), ordered.end(), [](const OutputSection *first, const OutputSection *second)
+    {
+        return first->address < second->address;
+    });
+    for (int i = 0; i < (int)ordered.size(); i++)
+    {
+        if ((uint64_t)ordered[i]->address + ordered[i]->size > MEMORY_SIZE)
+        {
+            addError("Section " + string(ordered[i]->name) + " does not fit in memory");
+        }
+        if (i > 0 && ordered[i - 1]->size > 0 && ordered[i]->size > 0 && ordered[i - 1]->address + ordered[i - 1]->size > ordered[i]->address)
+        {
+            addError("Sections " + string(ordered[i - 1]->name) + " and " + string(ordered[i]->name) + " overlap");
+        }
+    }
+}
+
+void Linker::mergeSections()
+{
+    // the output keeps the layout of an assembler object: undefined and absolute first
+    output.sections.clear();
+    ObjectSection undefinedSection = {};
+    undefinedSection.name = output.addString("UNDEFINED");
+    output.sections.push_back(undefinedSection);
+    ObjectSection absoluteSection = {};
+    absoluteSection.id = -1;
+    absoluteSection.name = output.addString("ABSOLUTE");
+    output.sections.push_back(absoluteSection);
+
+    for (int i = 0; i < (int)outputSections.size(); i++)
+    {
+        ObjectSection entry = {};
+        entry.id = i + 1;
+        entry.name = output.addString(outputSections[i].name);
+        entry.size = outputSections[i].size;
+        entry.dataOffset = output.data.size();
+        entry.firstZeroFill = output.zeroFills.size();
+
+        for (vector<pair<int, int>>::iterator piece = outputSections[i].pieces.begin(); piece != outputSections[i].pieces.end(); piece++)
+        {
+            const InputFile *file = inputFiles[piece->first];
+            const ObjectSection &section = file->object.sections[piece->second];
+            uint32_t storedBase = output.data.size() - entry.dataOffset;
+            for (uint32_t z = section.firstZeroFill; z < section.firstZeroFill + section.zeroFillCount; z++)
+            {
+                ObjectZeroFill fill = file->object.zeroFills[z];
+                fill.offset += file->sectionOffset[piece->second];
+                fill.dataOffset += storedBase;
+                output.zeroFills.push_back(fill);
+            }
+            const char *stored = file->object.data.data() + section.dataOffset;
+            output.data.insert(output.data.end(), stored, stored + section.dataSize);
+        }
+
+        entry.dataSize = output.data.size() - entry.dataOffset;
+        entry.zeroFillCount = output.zeroFills.size() - entry.firstZeroFill;
+        output.sections.push_back(entry);
+    }
+}
+
+bool Linker::symbolAddress(int file, int symbol, int &address)
+{
+    const ObjectFile &object = inputFiles[file]->object;
+    const ObjectSymbol &entry = object.symbols[symbol];
+
+    if (entry.type == OBJECT_SYMBOL_EXTERN || entry.type == OBJECT_SYMBOL_UNDEFINED)
+    {
+        unordered_map<string_view, GlobalSymbol>::iterator definition = globalSymbols.find(object.getString(entry.name));
+        if (definition == globalSymbols.end())
+        {
+            return false;
+        }
+        return symbolAddress(definition->second.file, definition->second.symbol, address);
+    }
+
+    if (entry.section == (int32_t)OBJECT_ABSOLUTE_SECTION)
+    {
+        address = entry.value;
+        return true;
+    }
+    int section = inputFiles[file]->outputSection[entry.section];
+    if (section < 0)
+    {
+        return false;
+    }
+    address = outputSections[section].address + inputFiles[file]->sectionOffset[entry.section] + entry.value;
+    return true;
+}
+
+char *Linker::fieldAddress(int outputSectionIndex, uint32_t offset)
+{
+    // zero fills before the offset take no room in the stored data
+    const ObjectSection &section = output.sections[outputSectionIndex + 2];
+    vector<ObjectZeroFill>::const_iterator first = output.zeroFills.begin() + section.firstZeroFill;
+    vector<ObjectZeroFill>::const_iterator last = first + section.zeroFillCount;
+    vector<ObjectZeroFill>::const_iterator fill = upper_bound(first, last, offset, [](uint32_t position, const ObjectZeroFill &zeroFill)
+    {
+        return position < zeroFill.offset;
+    });
+
+    if (fill != last && fill->offset <= offset + 1)
+    {
+        return nullptr;
+    }
+
+    uint32_t stored = offset;
+    if (fill != first)
+    {
+        fill--;
+        if (offset < fill->offset + fill->size)
+        {
+            return nullptr;
+        }
+        stored = offset - (fill->offset + fill->size - fill->dataOffset);
+    }
+    if (stored + 1 >= section.dataSize)
+    {
+        return nullptr;
+    }
+    return output.data.data() + section.dataOffset + stored;
+}
+
+void Linker::resolveAddresses()
+{
+    // final address of every symbol, so patching only indexes arrays
+    runTasks(inputFiles.size(), [this](int f)
+    {
+        InputFile *file = inputFiles[f];
+        file->symbolAddress.assign(file->object.symbols.size(), 0);
+        file->symbolDefined.assign(file->object.symbols.size(), 0);
+        for (int s = 0; s < (int)file->object.symbols.size(); s++)
+        {
+            file->symbolDefined[s] = symbolAddress(f, s, file->symbolAddress[s]);
+        }
+    });
+}
+
+void Linker::applyRelocations()
+{
+    // one task per input section, every task patches its own bytes of the output and keeps
+    // its own diagnostics, which are merged in section order
+    vector<RelocationTask> tasks;
+    for (int i = 0; i < (int)outputSections.size(); i++)
+    {
+        for (vector<pair<int, int>>::iterator piece = outputSections[i].pieces.begin(); piece != outputSections[i].pieces.end(); piece++)
+        {
+            if (inputFiles[piece->first]->object.sections[piece->second].relocationCount > 0)
+            {
+                tasks.push_back(RelocationTask(i, piece->first, piece->second));
+            }
+        }
+    }
+
+    vector<vector<string>> taskErrors(tasks.size());
+    runTasks(tasks.size(), [this, &tasks, &taskErrors](int t)
+    {
+        applySectionRelocations(tasks[t], taskErrors[t]);
+    });
+
+    for (vector<vector<string>>::iterator taskError = taskErrors.begin(); taskError != taskErrors.end(); taskError++)
+    {
+        errors.insert(errors.end(), taskError->begin(), taskError->end());
+    }
+}
+
+void Linker::applySectionRelocations(const RelocationTask &task, vector<string> &taskErrors)
+{
+    // instruction operands are stored high byte first and end at the relocation offset,
+    // .word data is stored low byte first and starts at it
+    InputFile *file = inputFiles[task.file];
+    const ObjectSection &section = file->object.sections[task.section];
+    const OutputSection &outputSection = outputSections[task.outputSection];
+    uint32_t pieceOffset = file->sectionOffset[task.section];
+
+    for (uint32_t r = section.firstRelocation; r < section.firstRelocation + section.relocationCount; r++)
+    {
+        const ObjectRelocation &relocation = file->object.relocations[r];
+        if (relocation.symbol == OBJECT_NO_SYMBOL)
+        {
+            continue;
+        }
+
+        if (!file->symbolDefined[relocation.symbol])
+        {
+            taskErrors.push_back("Undefined symbol " + string(file->object.getString(file->object.symbols[relocation.symbol].name)) + " referenced in " + file->path);
+            continue;
+        }
+
+        uint32_t position = pieceOffset + relocation.offset - (relocation.isData ? 0 : 1);
+        char *field = relocation.isData || relocation.offset > 0 ? fieldAddress(task.outputSection, position) : nullptr;
+        if (!field)
+        {
+            taskErrors.push_back("Relocation outside of section " + string(outputSection.name) + " in " + file->path);
+            continue;
+        }
+
+        unsigned char high = relocation.isData ? field[1] : field[0];
+        unsigned char low = relocation.isData ? field[0] : field[1];
+        int value = (int16_t)((high << 8) | low) + file->symbolAddress[relocation.symbol] + relocation.addend;
+        if (relocation.type == OBJECT_R_H_16_PC)
+        {
+            value -= outputSection.address + position;
+        }
+        else if (value < -0x8000 || value > 0xffff)
+        {
+            taskErrors.push_back("Value of symbol " + string(file->object.getString(file->object.symbols[relocation.symbol].name)) + " does not fit in 16 bits in " + file->path);
+            continue;
+        }
+
+        field[relocation.isData ? 1 : 0] = (value >> 8) & 0xff;
+        field[relocation.isData ? 0 : 1] = value & 0xff;
+    }
+}
+
+void Linker::buildRelocatable()
+{
+    // symbols of every file are copied, section symbols and globals are merged; the
+    // addend of a section relative relocation is in the field, so it moves by the
+    // offset of its input section in the output section
+    output.symbols.clear();
+    for (int s = 0; s < (int)output.sections.size(); s++)
+    {
+        ObjectSymbol entry = {};
+        entry.name = output.sections[s].name;
+        entry.section = s;
+        entry.id = s;
+        entry.type = OBJECT_SYMBOL_LOCAL;
+        output.symbols.push_back(entry);
+    }
+
+    vector<vector<int32_t>> symbolMap(inputFiles.size());
+    vector<vector<bool>> sectionSymbol(inputFiles.size());
+    for (int f = 0; f < (int)inputFiles.size(); f++)
+    {
+        InputFile *file = inputFiles[f];
+        const ObjectFile &object = file->object;
+        symbolMap[f].assign(object.symbols.size(), OBJECT_NO_SYMBOL);
+        sectionSymbol[f].assign(object.symbols.size(), false);
+
+        for (int s = 0; s < (int)object.symbols.size(); s++)
+        {
+            const ObjectSymbol &symbol = object.symbols[s];
+            if (symbol.type == OBJECT_SYMBOL_EXTERN || symbol.type == OBJECT_SYMBOL_UNDEFINED)
+            {
+                continue;
+            }
+
+            string_view name = object.getString(symbol.name);
+            if (symbol.type == OBJECT_SYMBOL_LOCAL && symbol.value == 0 && name == object.getString(object.sections[symbol.section].name))
+            {
+                sectionSymbol[f][s] = true;
+                symbolMap[f][s] = file->outputSection[symbol.section] < 0 ? symbol.section : file->outputSection[symbol.section] + 2;
+                continue;
+            }
+
+            ObjectSymbol entry = symbol;
+            entry.name = output.addString(name);
+            if (file->outputSection[symbol.section] >= 0)
+            {
+                entry.section = file->outputSection[symbol.section] + 2;
+                entry.value += file->sectionOffset[symbol.section];
+            }
+            entry.id = output.symbols.size();
+            symbolMap[f][s] = output.symbols.size();
+            output.symbols.push_back(entry);
+        }
+    }
+
+    // externs refer to the merged global, or to one extern per name when nothing defines it
+    unordered_map<string_view, int32_t> externSymbols;
+    for (int f = 0; f < (int)inputFiles.size(); f++)
+    {
+        const ObjectFile &object = inputFiles[f]->object;
+        for (int s = 0; s < (int)object.symbols.size(); s++)
+        {
+            const ObjectSymbol &symbol = object.symbols[s];
+            if (symbol.type != OBJECT_SYMBOL_EXTERN && symbol.type != OBJECT_SYMBOL_UNDEFINED)
+            {
+                continue;
+            }
+
+            string_view name = object.getString(symbol.name);
+            unordered_map<string_view, GlobalSymbol>::iterator definition = globalSymbols.find(name);
+            if (definition != globalSymbols.end())
+            {
+                symbolMap[f][s] = symbolMap[definition->second.file][definition->second.symbol];
+                continue;
+            }
+
+            pair<unordered_map<string_view, int32_t>::iterator, bool> inserted = externSymbols.insert(make_pair(name, (int32_t)output.symbols.size()));
+            if (inserted.second)
+            {
+                ObjectSymbol entry = {};
+                entry.name = output.addString(name);
+                entry.section = OBJECT_UNDEFINED_SECTION;
+                entry.id = output.symbols.size();
+                entry.type = OBJECT_SYMBOL_EXTERN;
+                output.symbols.push_back(entry);
+            }
+            symbolMap[f][s] = inserted.first->second;
+        }
+    }
+
+    output.relocations.clear();
+    for (int i = 0; i < (int)outputSections.size(); i++)
+    {
+        ObjectSection &entry = output.sections[i + 2];
+        entry.firstRelocation = output.relocations.size();
+
+        for (vector<pair<int, int>>::iterator piece = outputSections[i].pieces.begin(); piece != outputSections[i].pieces.end(); piece++)
+        {
+            InputFile *file = inputFiles[piece->first];
+            const ObjectSection &section = file->object.sections[piece->second];
+            uint32_t pieceOffset = file->sectionOffset[piece->second];
+
+            for (uint32_t r = section.firstRelocation; r < section.firstRelocation + section.relocationCount; r++)
+            {
+                ObjectRelocation relocation = file->object.relocations[r];
+                relocation.offset += pieceOffset;
+                if (relocation.symbol != OBJECT_NO_SYMBOL)
+                {
+                    int32_t symbol = relocation.symbol;
+                    uint32_t target = file->object.symbols[symbol].section;
+                    relocation.symbol = symbolMap[piece->first][symbol];
+                    if (sectionSymbol[piece->first][symbol] && file->outputSection[target] >= 0 && file->sectionOffset[target] > 0)
+                    {
+                        uint32_t position = relocation.offset - (relocation.isData ? 0 : 1);
+                        char *field = relocation.isData || relocation.offset > 0 ? fieldAddress(i, position) : nullptr;
+                        if (!field)
+                        {
+                            addError("Relocation outside of section " + string(outputSections[i].name) + " in " + file->path);
+                            continue;
+                        }
+                        unsigned char high = relocation.isData ? field[1] : field[0];
+                        unsigned char low = relocation.isData ? field[0] : field[1];
+                        int value = (int16_t)((high << 8) | low) + file->sectionOffset[target];
+                        field[relocation.isData ? 1 : 0] = (value >> 8) & 0xff;
+                        field[relocation.isData ? 0 : 1] = value & 0xff;
+                    }
+                }
+                output.relocations.push_back(relocation);
+            }
+        }
+
+        entry.relocationCount = output.relocations.size() - entry.firstRelocation;
+    }
+}
+
+bool Linker::writeHex()
+{
+    // eight bytes per row, rows that no section touches are left out
+    vector<int> ordered;
+    for (int i = 0; i < (int)outputSections.size(); i++)
+    {
+        if (outputSections[i].size > 0)
+        {
+            ordered.push_back(i);
+        }
+    }
+    stable_sort(ordered.begin(), ordered.end(), [this](int first, int second)
+    {
+        return outputSections[first].address < outputSections[second].address;
+    });
+
+    FileWriter *fw = new FileWriter(outputFilePath);
+    bool opened = fw->isFileOpened();
+    unsigned char row[8] = {};
+    uint32_t rowAddress = 0;
+    bool hasRow = false;
+    char line[64];
+    vector<char> bytes;
+
+    for (vector<int>::iterator index = ordered.begin(); index != ordered.end(); index++)
+    {
+        output.getSectionBytes(output.sections[*index + 2], bytes);
+        uint32_t address = outputSections[*index].address;
+        for (size_t b = 0; b < bytes.size(); b++, address++)
+        {
+            if (!hasRow || (address & ~7u) != rowAddress)
+            {
+                if (hasRow)
+                {
+                    snprintf(line, sizeof(line), "%04x: %02x %02x %02x %02x %02x %02x %02x %02x", rowAddress, row[0], row[1], row[2], row[3], row[4], row[5], row[6], row[7]);
+                    fw->writeLine(line);
+                }
+                fill(row, row + 8, 0);
+                rowAddress = address & ~7u;
+                hasRow = true;
+            }
+            row[address & 7] = bytes[b];
+        }
+    }
+    if (hasRow)
+    {
+        snprintf(line, sizeof(line), "%04x: %02x %02x %02x %02x %02x %02x %02x %02x", rowAddress, row[0], row[1], row[2], row[3], row[4], row[5], row[6], row[7]);
+        fw->writeLine(line);
+    }
+
+    delete fw;
+    return opened;
+}
+
+void Linker::addError(const string &message)
+{
+    errors.push_back(message);
+}
+
+void Linker::printErrors(ostream &messages)
+{
+    messages << "Linker detects some errors:" << endl;
+    for (vector<string>::iterator it = errors.begin(); it != errors.end(); it++)
+    {
+        messages << *it << endl;
+    }
+}
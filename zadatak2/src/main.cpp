@@ -0,0 +1,99 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "../inc/Linker.h"
+
+using namespace std;
+
+int main(int argc, const char *argv[])
+{
+    string outputFile;
+    bool hex = false, relocatable = false, hasInput = false, garbageCollection = false, hasEntry = false;
+    int threadCount = 0;
+    Linker *linker = new Linker();
+
+    for (int i = 1; i < argc; i++)
+    {
+        string argument = argv[i];
+        if (argument == "-o" && i + 1 < argc)
+        {
+            outputFile = argv[++i];
+        }
+        else if (argument == "-j" && i + 1 < argc)
+        {
+            threadCount = atoi(argv[++i]);
+        }
+        else if (argument == "--gc-sections")
+        {
+            garbageCollection = true;
+        }
+        else if (argument.rfind("--entry=", 0) == 0)
+        {
+            linker->setEntrySymbol(argument.substr(8));
+            hasEntry = true;
+        }
+        else if (argument == "-hex")
+        {
+            hex = true;
+        }
+        else if (argument == "-relocatable")
+        {
+            relocatable = true;
+        }
+        else if (argument.rfind("-place=", 0) == 0)
+        {
+            // -place=<section>@<address>, the address is decimal or 0x hexadecimal
+            size_t at = argument.find('@');
+            char *end = nullptr;
+            unsigned long address = at == string::npos ? 0 : strtoul(argument.c_str() + at + 1, &end, 0);
+            if (at == string::npos || at == 7 || end == argument.c_str() + at + 1 || *end != '\0' || address > 0xffff)
+            {
+                cout << "Bad placement: " << argument << endl;
+                delete linker;
+                return -1;
+            }
+            linker->addPlacement(argument.substr(7, at - 7), address);
+        }
+        else
+        {
+            linker->addInputFile(argument);
+            hasInput = true;
+        }
+    }
+
+    if (hex == relocatable)
+    {
+        cout << "Exactly one of -hex and -relocatable has to be given!" << endl;
+        delete linker;
+        return -1;
+    }
+    if (garbageCollection && !hex)
+    {
+        cout << "Option --gc-sections works only with -hex!" << endl;
+        delete linker;
+        return -1;
+    }
+    if (hasEntry && !garbageCollection)
+    {
+        cout << "Option --entry is a root of --gc-sections and needs it!" << endl;
+        delete linker;
+        return -1;
+    }
+    if (outputFile == "" || !hasInput)
+    {
+        cout << "Output file and at least one input file are needed!" << endl;
+        delete linker;
+        return -1;
+    }
+
+    linker->setOutputFile(outputFile);
+    linker->setOutputFormat(hex ? Linker::HEX : Linker::RELOCATABLE);
+    linker->setGarbageCollection(garbageCollection);
+    WorkerPool *pool = new WorkerPool(threadCount);
+    linker->setWorkerPool(pool);
+    bool linked = linker->link();
+    delete linker;
+    delete pool;
+    return linked ? 0 : 1;
+}
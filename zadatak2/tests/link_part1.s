@@ -0,0 +1,15 @@
+# file link_part1.s
+.global fa
+.extern fb
+.section text
+fa:
+    .skip 3
+la:
+    jmp la
+    ldr r1, %ld
+    call fb
+.section data
+ld:
+    .word la
+    .word fb
+.end
@@ -0,0 +1,14 @@
+# file link_part2.s
+.global fb
+.section text
+    .skip 2
+fb:
+    jmp lb
+lb:
+    ldr r2, %dd
+    jmp %lb
+.section data
+    .skip 4
+dd:
+    .word lb
+.end
@@ -0,0 +1,80 @@
+#!/bin/bash
+
+# Links the sample objects into memory images and compares them with the expected
+# ones, once directly and once through a combined relocatable object. The archive
+# holds the second half of both programs, linking it must only pull in that half.
+# Garbage collection must drop the sections that nothing reaches and keep the rest.
+# A damaged object has to be rejected, not linked.
+
+ASSEMBLER=../zadatak1/asembler
+WORK_DIR=$(mktemp -d)
+trap "rm -rf $WORK_DIR" EXIT
+failed=0
+
+assemble()
+{
+    $ASSEMBLER --format=binary -o $WORK_DIR/$(basename $1 .s).o $1 > /dev/null || failed=1
+}
+
+check()
+{
+    # check <expected hex> <placements> <objects...>
+    expected=$1 places=$2
+    shift 2
+    ./linker -hex $places -o $WORK_DIR/direct.hex "$@" || failed=1
+    ./linker -relocatable -o $WORK_DIR/combined.o "$@" || failed=1
+    ./linker -hex $places -o $WORK_DIR/combined.hex $WORK_DIR/combined.o || failed=1
+    for output in direct combined; do
+        if ! cmp -s $expected $WORK_DIR/$output.hex; then
+            echo "$expected: $output link differs"
+            failed=1
+        fi
+    done
+}
+
+expectError()
+{
+    # expectError <message> <linker arguments...>
+    message=$1
+    shift
+    ./linker "$@" > $WORK_DIR/errors.txt
+    status=$?
+    if [ $status -ne 1 ] || ! grep -qF "$message" $WORK_DIR/errors.txt; then
+        echo "linker $*: expected \"$message\" (exit $status)"
+        failed=1
+    fi
+}
+
+assemble ../zadatak1/tests/projmain.s
+assemble ../zadatak1/tests/projinterrupts.s
+assemble tests/link_part1.s
+assemble tests/link_part2.s
+assemble ../zadatak1/tests/test_write_part2.s
+assemble tests/section_symbol1.s
+assemble tests/section_symbol2.s
+
+check tests/proj.hex "-place=ivt@0x0000 -place=myCode@0x4000" $WORK_DIR/projinterrupts.o $WORK_DIR/projmain.o
+check tests/link_part.hex "-place=text@0x100" $WORK_DIR/link_part1.o $WORK_DIR/link_part2.o
+check tests/section_symbol.hex "-place=text@0x100" $WORK_DIR/section_symbol1.o $WORK_DIR/section_symbol2.o
+
+./archiver -o $WORK_DIR/library.a $WORK_DIR/link_part2.o $WORK_DIR/projmain.o || failed=1
+check tests/proj.hex "-place=ivt@0x0000 -place=myCode@0x4000" $WORK_DIR/projinterrupts.o $WORK_DIR/library.a
+check tests/link_part.hex "-place=text@0x100" $WORK_DIR/link_part1.o $WORK_DIR/library.a
+
+check tests/proj.hex "--gc-sections -place=ivt@0x0000 -place=myCode@0x4000" $WORK_DIR/projinterrupts.o $WORK_DIR/projmain.o $WORK_DIR/link_part1.o $WORK_DIR/link_part2.o
+check tests/link_part.hex "--gc-sections --entry=fa -place=text@0x100" $WORK_DIR/link_part1.o $WORK_DIR/link_part2.o
+expectError "there is no ivt section and no --entry symbol" -hex --gc-sections -o $WORK_DIR/error.hex $WORK_DIR/link_part1.o $WORK_DIR/link_part2.o
+expectError "Placed section text was removed by --gc-sections" -hex --gc-sections -place=text@0x100 -o $WORK_DIR/error.hex $WORK_DIR/projinterrupts.o $WORK_DIR/projmain.o $WORK_DIR/link_part1.o $WORK_DIR/link_part2.o
+expectError "Entry symbol B_value is not in a section" -hex --gc-sections --entry=B_value -o $WORK_DIR/error.hex $WORK_DIR/test_write_part2.o
+
+# point the first zero fill of the interrupt table far behind the stored bytes
+cp $WORK_DIR/projinterrupts.o $WORK_DIR/corrupt.o
+zeroFillTable=$(od -An -tu4 -j36 -N4 $WORK_DIR/corrupt.o | tr -d ' ')
+printf '\xff\xff\xff\x7f' | dd of=$WORK_DIR/corrupt.o bs=1 seek=$((zeroFillTable + 8)) conv=notrunc 2> /dev/null
+expectError "Cannot read object file: $WORK_DIR/corrupt.o" -hex -o $WORK_DIR/corrupt.hex $WORK_DIR/corrupt.o $WORK_DIR/projmain.o
+
+if [ $failed -ne 0 ]; then
+    echo "Linker: FAILED"
+    exit 1
+fi
+echo "Linker: all links match"
@@ -0,0 +1,10 @@
+# file section_symbol1.s
+# the section data has the name of a global from another file
+.global data
+.section text
+    .word x
+    ldr r0, x
+.section data
+x:
+    .word 5
+.end
@@ -0,0 +1,7 @@
+# file section_symbol2.s
+.global data
+.section other
+    .word 0x1111
+data:
+    .word 0x2222
+.end